@@ -0,0 +1,458 @@
+/*
+ *   Switch panel benchmark: feeds SwitchPnl, with its real ISRs and Timer1
+ *  settle delays, scripted pin waveforms with contact bounce, and polls it
+ *  like the switches task. For each scenario it reports the events missed
+ *  and duplicated, the detection latency and the host time per check() call
+ *  and per pin edge (including the ISR), so debouncing and decoding changes
+ *  can be compared.
+ *   Bounce is a burst of random toggles after each clean edge, within the
+ *  bounce length. Jitter delays each clean edge at random up to its value.
+ *  The main loop can stall for a while every second, to check that events
+ *  are kept until it polls again.
+ *  Usage: bench_switch [--seed N] [--events N]
+ *                      [--switch enter|back|select] [--bounce MS]
+ *                      [--jitter MS] [--rate DETENTS_PER_S] [--busy MS]
+ *  With --switch it runs that scenario only, otherwise a fixed set. Exits
+ *  with 1 when an event is missed or duplicated in a scenario whose bounce
+ *  is within the limits: shorter than the settle time of the button minus
+ *  the 1 ms timer resolution, or, with the jitter, than a quarter of the
+ *  detent period of the encoder.
+ */
+
+#include "config.h"
+#include <stdio.h>
+#include <chrono>
+#include <random>
+#include <vector>
+#include <deque>
+#include <algorithm>
+#include "switchpnl.h"
+#include "hostsim.h"
+
+
+/*************/
+/* Constants */
+/*************/
+
+// Same pins as the sketch
+static const uint8_t PIN_ENC_A = 2U;
+static const uint8_t PIN_ENC_B = 3U;
+static const uint8_t PIN_BTN_ENT = 9U;
+static const uint8_t PIN_BTN_BCK = 10U;
+
+static const uint64_t US_PER_MS = 1000ULL;
+static const uint64_t BUSY_PERIOD_US = 1000ULL * US_PER_MS;
+static const uint64_t SETTLE_WAIT_US = 100ULL * US_PER_MS;
+static const unsigned DEFAULT_EVENTS = 200U;
+static const uint8_t MAX_BOUNCES = 3U;  // Toggle pairs per bounce burst
+static const unsigned REVERSE_DETENTS = 10U;  // Turn direction changes
+
+
+/*********/
+/* Types */
+/*********/
+
+// Switch of a scenario
+enum Switch_t: uint8_t
+{
+  SwEnter = 0U, SwBack, SwSelect
+};
+
+// Scenario parameters
+struct Scenario_t
+{
+  const char *pName;
+  Switch_t Switch;
+  double BounceMs;   // Bounce after each clean edge
+  double JitterMs;   // Random delay of each clean edge
+  double Rate;       // Clicks or detents per second
+  double BusyMs;     // Main loop stall every second
+  bool Reverse;      // Encoder: change direction every REVERSE_DETENTS
+};
+
+// Pin change
+struct Edge_t
+{
+  uint64_t Us;
+  uint8_t Pin;
+  uint8_t Level;
+};
+
+// Expected event, in the order it must be reported
+struct Expected_t
+{
+  uint64_t Us;              // Clean edge that must raise it
+  Event::SwitchEvent SwE;   // For buttons
+  int8_t Step;              // For the encoder: +1 or -1
+};
+
+// Results of a scenario
+struct Result_t
+{
+  unsigned Expected, Missed, Duplicated;
+  double LatencyMinMs, LatencyMaxMs, LatencySumMs;
+  unsigned Latencies;
+  unsigned long Checks, Edges;
+  double CheckNs, EdgeNs;  // Host time, totals
+};
+
+
+/*************/
+/* Variables */
+/*************/
+
+static SwitchPnl Panel(PIN_ENC_A, PIN_ENC_B, PIN_BTN_ENT, PIN_BTN_BCK);
+static std::mt19937 Rng;
+
+
+/*************/
+/* Functions */
+/*************/
+
+/*
+ *   Returns a random number in [0, Max).
+ */
+static double uniform(double Max)
+{
+  return std::uniform_real_distribution<double>(0.0, Max)(Rng);
+}
+
+
+/*
+ *   Adds a clean edge to a waveform, followed by its bounce: pairs of
+ *  toggles within the bounce length, so the pin ends at the new level.
+ *  Parameters:
+ *  * Edges: waveform.
+ *  * Us: time of the clean edge.
+ *  * Pin, Level: pin and new level.
+ *  * BounceUs: bounce length, 0 for none.
+ */
+static void addEdge(std::vector<Edge_t> &Edges, uint64_t Us, uint8_t Pin,
+  uint8_t Level, uint64_t BounceUs)
+{
+  std::vector<uint64_t> Times;
+
+  Edges.push_back({ Us, Pin, Level });
+  if (!BounceUs)
+    return;
+
+  // Distinct times, the last one at the end of the bounce
+  for (uint8_t Idx = 1U + 2U * (Rng() % MAX_BOUNCES); Idx > 1U; Idx--)
+    Times.push_back(Us + 1U + (uint64_t) uniform(BounceUs - 1U));
+  Times.push_back(Us + BounceUs);
+  std::sort(Times.begin(), Times.end());
+  Times.erase(std::unique(Times.begin(), Times.end()), Times.end());
+  if (Times.size() % 2U)
+    Times.erase(Times.begin());
+
+  for (size_t Idx = 0U; Idx < Times.size(); Idx++)
+    Edges.push_back({ Times[Idx], Pin, (uint8_t) (Idx % 2U? Level: !Level)
+      });
+}
+
+
+/*
+ *   Builds the waveform and expected events of a scenario.
+ *  Parameters:
+ *  * S: scenario.
+ *  * StartUs: time of the first edge.
+ *  * Events: clicks or detents.
+ *  * Edges, Expected: where to store them.
+ *  Returns: time when the waveform is over.
+ */
+static uint64_t buildWaveform(const Scenario_t &S, uint64_t StartUs,
+  unsigned Events, std::vector<Edge_t> &Edges,
+  std::vector<Expected_t> &Expected)
+{
+  uint64_t PeriodUs = (uint64_t) (1e6 / S.Rate);
+  uint64_t BounceUs = (uint64_t) (S.BounceMs * US_PER_MS);
+  uint64_t JitterUs = (uint64_t) (S.JitterMs * US_PER_MS);
+  uint64_t Us = StartUs;
+
+  for (unsigned Idx = 0U; Idx < Events; Idx++, Us += PeriodUs)
+  {
+    if (S.Switch == SwSelect)
+    {
+      // Quadrature cycle 11 01 00 10 11 clockwise, a pin per quarter
+      static const uint8_t Pins[4] = { PIN_ENC_A, PIN_ENC_B, PIN_ENC_A,
+        PIN_ENC_B };
+      static const uint8_t Levels[4] = { LOW, LOW, HIGH, HIGH };
+      bool Up = !S.Reverse || Idx / REVERSE_DETENTS % 2U == 0U;
+      uint64_t QuarterUs = PeriodUs / 4U;
+      uint64_t EdgeUs = 0U;
+
+      for (uint8_t Quarter = 0U; Quarter < 4U; Quarter++)
+      {
+        // Counter clockwise: same levels, pins swapped
+        uint8_t Pin = Up? Pins[Quarter]: Pins[(Quarter + 1U) % 4U];
+
+        EdgeUs = Us + Quarter * QuarterUs +
+          (uint64_t) uniform(JitterUs + 1U);
+        addEdge(Edges, EdgeUs, Pin, Levels[Quarter], BounceUs);
+      }
+      Expected.push_back({ EdgeUs, Event::SwEvNone, (int8_t) (Up? 1: -1) });
+    }
+    else
+    {
+      // Pressed half the period
+      uint8_t Pin = S.Switch == SwEnter? PIN_BTN_ENT: PIN_BTN_BCK;
+      uint64_t PressUs = Us + (uint64_t) uniform(JitterUs + 1U);
+      uint64_t ReleaseUs = Us + PeriodUs / 2U +
+        (uint64_t) uniform(JitterUs + 1U);
+
+      addEdge(Edges, PressUs, Pin, LOW, BounceUs);
+      addEdge(Edges, ReleaseUs, Pin, HIGH, BounceUs);
+      Expected.push_back({ PressUs, S.Switch == SwEnter?
+        Event::SwEvEnterPress: Event::SwEvBackPress, 0 });
+      Expected.push_back({ ReleaseUs, S.Switch == SwEnter?
+        Event::SwEvEnterRelease: Event::SwEvBackRelease, 0 });
+    }
+  }
+
+  std::stable_sort(Edges.begin(), Edges.end(),
+    [](const Edge_t &Left, const Edge_t &Right)
+    {
+      return Left.Us < Right.Us;
+    });
+
+  return Us + SETTLE_WAIT_US;
+}
+
+
+/*
+ *   Records the detection of an expected event.
+ */
+static void addLatency(Result_t &R, uint64_t EdgeUs)
+{
+  double Ms = (hostMicros() - EdgeUs) / (double) US_PER_MS;
+
+  if (!R.Latencies || Ms < R.LatencyMinMs)
+    R.LatencyMinMs = Ms;
+  if (!R.Latencies || Ms > R.LatencyMaxMs)
+    R.LatencyMaxMs = Ms;
+  R.LatencySumMs += Ms;
+  R.Latencies++;
+}
+
+
+/*
+ *   Runs a scenario: applies the edges on time and polls the panel every
+ *  SWITCH_CHECK_INTERVAL but while the main loop is stalled, matching what
+ *  check() reports with the expected events.
+ *  Returns: the results.
+ */
+static Result_t runScenario(const Scenario_t &S, unsigned Events)
+{
+  typedef std::chrono::steady_clock HostClock;
+  std::vector<Edge_t> Edges;
+  std::vector<Expected_t> Expected;
+  std::deque<Expected_t> Pending;  // Expected and not reported yet
+  Result_t R = Result_t();
+  uint64_t StartUs = hostMicros();
+  uint64_t EndUs = buildWaveform(S, StartUs, Events, Edges, Expected);
+  uint64_t PollUs = StartUs;
+  uint64_t BusyUs = (uint64_t) (S.BusyMs * US_PER_MS);
+  size_t NextEdge = 0U, NextExpected = 0U;
+  unsigned StepsUp = 0U, StepsDown = 0U, ExpUp = 0U, ExpDown = 0U;
+
+  R.Expected = Expected.size();
+  while (PollUs <= EndUs)
+  {
+    // Edges up to the next poll
+    while (NextEdge < Edges.size() && Edges[NextEdge].Us <= PollUs)
+    {
+      const Edge_t &E = Edges[NextEdge++];
+
+      hostAdvanceTo(E.Us);
+      HostClock::time_point Start = HostClock::now();
+      hostSetPin(E.Pin, E.Level);
+      R.EdgeNs += std::chrono::duration<double, std::nano>(
+        HostClock::now() - Start).count();
+      R.Edges++;
+    }
+    hostAdvanceTo(PollUs);
+    while (NextExpected < Expected.size() &&
+        Expected[NextExpected].Us <= PollUs)
+      Pending.push_back(Expected[NextExpected++]);
+
+    // Poll unless stalled, like the switches task: until there is none
+    if ((PollUs - StartUs) % BUSY_PERIOD_US >= BusyUs)
+    {
+      for (;;)
+      {
+        int8_t Steps;
+        uint8_t DetentMs;
+
+        HostClock::time_point Start = HostClock::now();
+        Event::SwitchEvent SwE = Panel.check(&Steps, &DetentMs);
+        R.CheckNs += std::chrono::duration<double, std::nano>(
+          HostClock::now() - Start).count();
+        R.Checks++;
+
+        if (SwE == Event::SwEvNone)
+          break;
+
+        if (SwE == Event::SwEvSelect)
+        {
+          // Detents in order, each may be a merge of several
+          for (int8_t Step = Steps > 0? 1: -1; Steps; Steps -= Step)
+          {
+            (Step > 0? StepsUp: StepsDown)++;
+            while (!Pending.empty() && Pending.front().Step != Step)
+              Pending.pop_front();
+            if (!Pending.empty())
+            {
+              addLatency(R, Pending.front().Us);
+              Pending.pop_front();
+            }
+          }
+        }
+        else if (!Pending.empty() && Pending.front().SwE == SwE)
+        {
+          addLatency(R, Pending.front().Us);
+          Pending.pop_front();
+        }
+        else
+          R.Duplicated++;
+      }
+    }
+
+    PollUs += SWITCH_CHECK_INTERVAL * US_PER_MS;
+  }
+
+  // Encoder: by direction, as merged detents can not be told apart
+  if (S.Switch == SwSelect)
+  {
+    for (size_t Idx = 0U; Idx < Expected.size(); Idx++)
+      (Expected[Idx].Step > 0? ExpUp: ExpDown)++;
+    R.Missed = (ExpUp > StepsUp? ExpUp - StepsUp: 0U) +
+      (ExpDown > StepsDown? ExpDown - StepsDown: 0U);
+    R.Duplicated = (StepsUp > ExpUp? StepsUp - ExpUp: 0U) +
+      (StepsDown > ExpDown? StepsDown - ExpDown: 0U);
+  }
+  else
+    R.Missed = R.Expected - R.Latencies;
+
+  return R;
+}
+
+
+/*
+ *   Returns whether the bounce of a scenario is within what the panel is
+ *  meant to handle. The settle delay counts ticks of the free running 1 ms
+ *  timer, so it can be up to 1 ms shorter than the settle time.
+ */
+static bool withinLimits(const Scenario_t &S)
+{
+  switch (S.Switch)
+  {
+  case SwEnter:
+    return S.BounceMs < SWITCH_SETTLE_MS_ENTER - 1U;
+  case SwBack:
+    return S.BounceMs < SWITCH_SETTLE_MS_BACK - 1U;
+  default:
+    return S.BounceMs + S.JitterMs < 1000.0 / S.Rate / 4.0;
+  }
+}
+
+
+/*
+ *   Runs a scenario and prints its results.
+ *  Returns: whether it passed.
+ */
+static bool benchmark(const Scenario_t &S, unsigned Events)
+{
+  Result_t R = runScenario(S, Events);
+  bool Within = withinLimits(S);
+  bool Pass = !Within || (!R.Missed && !R.Duplicated);
+
+  printf("%-18s %6.1f %6.1f %6.0f %5.0f %5u %5u %5u %6.2f %6.2f %6.2f "
+    "%6.0f %6.0f %s\n", S.pName, S.BounceMs, S.JitterMs, S.Rate, S.BusyMs,
+    R.Expected, R.Missed, R.Duplicated, R.LatencyMinMs,
+    R.Latencies? R.LatencySumMs / R.Latencies: 0.0, R.LatencyMaxMs,
+    R.Checks? R.CheckNs / R.Checks: 0.0, R.Edges? R.EdgeNs / R.Edges: 0.0,
+    !Within? "beyond limits": Pass? "ok": "FAIL");
+
+  return Pass;
+}
+
+
+int main(int argc, char *argv[])
+{
+  static const Scenario_t Scenarios[] =
+  {
+    // Name, switch, bounce, jitter, rate, busy, reverse
+    { "enter clean", SwEnter, 0.0, 0.0, 5.0, 0.0, false },
+    { "enter bounce", SwEnter, 3.0, 2.0, 5.0, 0.0, false },
+    { "enter bounce max", SwEnter, 3.9, 0.0, 8.0, 0.0, false },
+    { "enter busy loop", SwEnter, 3.0, 1.0, 8.0, 300.0, false },
+    { "enter long bounce", SwEnter, 8.0, 0.0, 5.0, 0.0, false },
+    { "back bounce", SwBack, 8.0, 2.0, 5.0, 0.0, false },
+    { "back busy loop", SwBack, 8.0, 1.0, 6.0, 300.0, false },
+    { "select slow", SwSelect, 0.0, 0.0, 5.0, 0.0, false },
+    { "select bounce", SwSelect, 1.0, 0.5, 50.0, 0.0, false },
+    { "select fast", SwSelect, 0.3, 0.1, 200.0, 0.0, false },
+    { "select reverse", SwSelect, 0.5, 0.5, 40.0, 0.0, true },
+    { "select busy loop", SwSelect, 0.5, 0.5, 40.0, 300.0, false },
+    { "select bouncy", SwSelect, 2.0, 0.0, 200.0, 0.0, false },
+  };
+  Scenario_t Custom = { "custom", SwEnter, 0.0, 0.0, 5.0, 0.0, false };
+  bool HasCustom = false, Pass = true;
+  unsigned Events = DEFAULT_EVENTS;
+  unsigned long Seed = 1UL;
+
+  // Options, all with a value
+  for (int Arg = 1; Arg < argc; Arg += 2)
+  {
+    const char *pOpt = argv[Arg];
+    const char *pValue = Arg + 1 < argc? argv[Arg + 1]: nullptr;
+    bool Valid = pValue;
+
+    if (!Valid)
+      ;
+    else if (!strcmp(pOpt, "--seed"))
+      Seed = strtoul(pValue, nullptr, 10);
+    else if (!strcmp(pOpt, "--events"))
+      Events = strtoul(pValue, nullptr, 10);
+    else if (!strcmp(pOpt, "--switch"))
+    {
+      HasCustom = true;
+      Custom.Switch = !strcmp(pValue, "back")? SwBack:
+        !strcmp(pValue, "select")? SwSelect: SwEnter;
+    }
+    else if (!strcmp(pOpt, "--bounce"))
+      Custom.BounceMs = atof(pValue);
+    else if (!strcmp(pOpt, "--jitter"))
+      Custom.JitterMs = atof(pValue);
+    else if (!strcmp(pOpt, "--rate"))
+      Custom.Rate = atof(pValue);
+    else if (!strcmp(pOpt, "--busy"))
+      Custom.BusyMs = atof(pValue);
+    else
+      Valid = false;
+
+    if (!Valid)
+    {
+      fprintf(stderr, "Usage: %s [--seed N] [--events N] "
+        "[--switch enter|back|select] [--bounce MS] [--jitter MS] "
+        "[--rate N] [--busy MS]\n", argv[0]);
+      return 2;
+    }
+  }
+
+  Rng.seed(Seed);
+  Panel.init();
+
+  printf("%-18s %6s %6s %6s %5s %5s %5s %5s %6s %6s %6s %6s %6s\n",
+    "scenario", "bounce", "jitter", "rate", "busy", "exp", "miss", "dup",
+    "latmin", "latavg", "latmax", "ns/chk", "ns/edg");
+  printf("%-18s %6s %6s %6s %5s %5s %5s %5s %6s %6s %6s\n", "", "ms", "ms",
+    "1/s", "ms", "", "", "", "ms", "ms", "ms");
+  if (HasCustom)
+    Pass = benchmark(Custom, Events);
+  else
+    for (size_t Idx = 0U; Idx < sizeof Scenarios / sizeof *Scenarios; Idx++)
+      Pass = benchmark(Scenarios[Idx], Events) && Pass;
+
+  return Pass? 0: 1;
+}
@@ -0,0 +1,293 @@
+/*
+ *   Runs the whole firmware on the host: setup() and loop() of the sketch,
+ *  on virtual time. It boots with the RTC at a given UTC time, checks that
+ *  the main page shows it, opens the diagnostics page holding Enter, opens
+ *  the time page from the config page, edits a meal and keeps running the
+ *  given simulated hours. Then it prints the display and some counters.
+ *  Usage: catfeeder [--utc UNIXTIME] [--hours HOURS] [--serial]
+ *  Exits with 1 when the display does not show what it should.
+ */
+
+#include "catfeeder.ino"
+#include <stdio.h>
+#include <time.h>
+#include "hostsim.h"
+
+
+/*************/
+/* Constants */
+/*************/
+
+static const uint32_t DEFAULT_UTC = 1774656000UL;  // 2026-03-28 00:00 UTC
+static const unsigned long DEFAULT_HOURS = 1UL;
+static const uint64_t US_PER_S = 1000000ULL;
+static const uint64_t PRESS_US = 100000ULL;   // Button press and release
+static const uint64_t DETENT_US = 40000ULL;   // Encoder detent
+static const uint64_t FAST_DETENT_US = 4000ULL;
+static const uint8_t FAST_DETENTS = 250U;     // A second
+static const uint8_t MEALS_OPTION = 1U;       // Options in the config page
+static const uint8_t TIME_OPTION = 2U;
+
+// Diagnostics page with the fixed figures of the memdiag shim
+#if defined(LOCALE_ES)
+static const char DIAG_ROW0[] = "DAT0214  BSS1083";
+static const char DIAG_ROW1[] = "P0367 L0384/0512";
+#else
+static const char DIAG_ROW0[] = "DAT0214  BSS1083";
+static const char DIAG_ROW1[] = "S0367 F0384/0512";
+#endif
+
+
+/*************/
+/* Functions */
+/*************/
+
+/*
+ *   Runs the sketch loop until a virtual time.
+ *  Parameters:
+ *  * Us: virtual time to stop at.
+ *  Returns: loop() calls.
+ */
+static unsigned long runUntil(uint64_t Us)
+{
+  unsigned long Loops = 0UL;
+
+  while (hostMicros() < Us)
+  {
+    loop();
+    Loops++;
+  }
+
+  return Loops;
+}
+
+
+/*
+ *   Returns whether a display line starts with a text.
+ */
+static bool lcdStarts(uint8_t Row, const char *pText)
+{
+  return !strncmp(hostLcdLine(Row), pText, strlen(pText));
+}
+
+
+/*
+ *   Presses and releases a button, running the sketch meanwhile.
+ *  Parameters:
+ *  * Pin: pin of the button.
+ *  Returns: loop() calls.
+ */
+static unsigned long pressButton(uint8_t Pin)
+{
+  unsigned long Loops;
+
+  hostSetPin(Pin, LOW);
+  Loops = runUntil(hostMicros() + PRESS_US);
+  hostSetPin(Pin, HIGH);
+
+  return Loops + runUntil(hostMicros() + PRESS_US);
+}
+
+
+/*
+ *   Schedules a clockwise turn of the encoder, its edges happening on
+ *  virtual time whatever the sketch is doing.
+ *  Parameters:
+ *  * StartUs: virtual time of the first edge.
+ *  * Detents: detents to turn.
+ *  * DetentUs: time of each detent.
+ *  Returns: virtual time when the turn is over.
+ */
+static uint64_t scheduleTurn(uint64_t StartUs, uint8_t Detents,
+  uint64_t DetentUs)
+{
+  // Quadrature cycle 11 01 00 10 11, a pin per quarter
+  static const uint8_t Pins[4] = { PIN_ENC[0], PIN_ENC[1], PIN_ENC[0],
+    PIN_ENC[1] };
+  static const uint8_t Levels[4] = { LOW, LOW, HIGH, HIGH };
+
+  for (uint8_t Detent = 0U; Detent < Detents; Detent++)
+    for (uint8_t Quarter = 0U; Quarter < 4U; Quarter++)
+    {
+      hostSetPinAt(StartUs, Pins[Quarter], Levels[Quarter]);
+      StartUs += DetentUs / 4U;
+    }
+
+  return StartUs;
+}
+
+
+/*
+ *   Turns the encoder clockwise, running the sketch meanwhile.
+ *  Parameters:
+ *  * Detents: detents to turn.
+ *  Returns: loop() calls.
+ */
+static unsigned long turnEncoder(uint8_t Detents)
+{
+  return runUntil(scheduleTurn(hostMicros(), Detents, DETENT_US) + PRESS_US);
+}
+
+
+/*
+ *   Checks that a display line is a text, reporting it when not.
+ *  Returns: whether it is.
+ */
+static bool lcdIs(uint8_t Row, const char *pText)
+{
+  if (!strcmp(hostLcdLine(Row), pText))
+    return true;
+
+  printf("FAIL: row %u is \"%s\", expected \"%s\"\n", Row,
+    hostLcdLine(Row), pText);
+  return false;
+}
+
+
+/*
+ *   Checks that the main page shows the current official time, calculated
+ *  from the virtual RTC: the same conversion as the firmware, but the
+ *  display has to be up to date.
+ *  Returns: whether it does.
+ */
+static bool timeShown()
+{
+  DateTime Official = Rtc.getOfficial();
+  char Expected[8];
+
+  snprintf(Expected, sizeof Expected, "%02u:%02u", Official.hour(),
+    Official.minute());
+  if (lcdStarts(0U, Expected))
+    return true;
+
+  printf("FAIL: time %s not shown\n", Expected);
+  return false;
+}
+
+
+/*
+ *   Checks that the time page shows the current UTC date, with the year in
+ *  full. The time row is not checked, as the hour widget blinks.
+ *  Returns: whether it does.
+ */
+static bool dateShown()
+{
+  DateTime Utc = Rtc.getUtc();
+  char Expected[24];
+
+  snprintf(Expected, sizeof Expected, "UTC   %02u/%02u/%04u", Utc.day(),
+    Utc.month(), Utc.year());
+
+  return lcdIs(1U, Expected);
+}
+
+
+/*
+ *   Prints the display between bars.
+ */
+static void printLcd(const char *pTitle)
+{
+  printf("%s:\n", pTitle);
+  for (uint8_t Row = 0U; Row < DISPLAY_ROWS; Row++)
+    printf("  |%s|\n", hostLcdLine(Row));
+}
+
+
+int main(int argc, char *argv[])
+{
+  uint32_t Utc = DEFAULT_UTC;
+  unsigned long Hours = DEFAULT_HOURS;
+  unsigned long Loops;
+  int Status = 0;
+
+  for (int Arg = 1; Arg < argc; Arg++)
+  {
+    if (!strcmp(argv[Arg], "--utc") && Arg + 1 < argc)
+      Utc = strtoul(argv[++Arg], nullptr, 10);
+    else if (!strcmp(argv[Arg], "--hours") && Arg + 1 < argc)
+      Hours = strtoul(argv[++Arg], nullptr, 10);
+    else if (!strcmp(argv[Arg], "--serial"))
+      hostSerialEcho(true);
+    else
+    {
+      fprintf(stderr,
+        "Usage: %s [--utc UNIXTIME] [--hours HOURS] [--serial]\n", argv[0]);
+      return 2;
+    }
+  }
+
+  // Boot, on a blank EEPROM
+  hostRtcSet(Utc);
+  setup();
+  Loops = runUntil(US_PER_S);
+  printLcd("Boot");
+
+  if (!timeShown())
+    Status = 1;
+
+  // Hold Enter to open the diagnostics page, Back to leave it
+  hostSetPin(PIN_BTN_ENT, LOW);
+  Loops += runUntil(hostMicros() + (DIAG_HOLD_MS + 100UL) * 1000ULL);
+  hostSetPin(PIN_BTN_ENT, HIGH);
+  Loops += runUntil(hostMicros() + US_PER_S);
+  printLcd("Enter held");
+  if (!lcdIs(0U, DIAG_ROW0) || !lcdIs(1U, DIAG_ROW1))
+    Status = 1;
+  hostSetPin(PIN_BTN_BCK, LOW);
+  Loops += runUntil(hostMicros() + US_PER_S / 2U);
+  hostSetPin(PIN_BTN_BCK, HIGH);
+  Loops += runUntil(hostMicros() + US_PER_S / 2U);
+
+  // Enter opens the config page, where the time page is the third option.
+  // Back sets the time shown and goes back to the config page, then to the
+  // main page
+  Loops += pressButton(PIN_BTN_ENT);
+  Loops += turnEncoder(TIME_OPTION);
+  Loops += pressButton(PIN_BTN_ENT);
+  printLcd("Time page");
+  if (!dateShown())
+    Status = 1;
+  Loops += pressButton(PIN_BTN_BCK);
+  Loops += pressButton(PIN_BTN_BCK);
+
+  // Edit the hour of the first two meals and leave the config pages
+  // turning the knob fast: the meals are saved right away all the same
+  Loops += pressButton(PIN_BTN_ENT);
+  Loops += turnEncoder(MEALS_OPTION);
+  Loops += pressButton(PIN_BTN_ENT);
+  for (uint8_t Meal = 0U; Meal < 2U; Meal++)
+  {
+    if (Meal)
+      Loops += turnEncoder(1U);
+    Loops += pressButton(PIN_BTN_ENT);
+    Loops += turnEncoder(1U);
+    Loops += pressButton(PIN_BTN_BCK);
+  }
+  Loops += pressButton(PIN_BTN_BCK);
+  hostSetPin(PIN_BTN_BCK, LOW);
+  hostSetPinAt(hostMicros() + PRESS_US, PIN_BTN_BCK, HIGH);
+  Loops += runUntil(scheduleTurn(hostMicros(), FAST_DETENTS, FAST_DETENT_US) +
+    PRESS_US);
+  if (FeedData.isDirty())
+  {
+    printf("FAIL: edited meals not saved after config\n");
+    Status = 1;
+  }
+
+  // Keep running
+  clock_t Start = clock();
+  Loops += runUntil(hostMicros() + Hours * 3600ULL * US_PER_S);
+  double Seconds = (double) (clock() - Start) / CLOCKS_PER_SEC;
+  printLcd("End");
+  printf("virtual %.0f s in %.2f s of CPU, %lu loops, %lu RTC reads, "
+    "%lu EEPROM writes, %lu auger steps\n",
+    hostMicros() / (double) US_PER_S, Seconds, Loops, hostRtcReads(),
+    hostEepromWrites(), hostPinRises(PIN_ED_STEP));
+  for (uint8_t Id = 0U; Id < TkNum; Id++)
+    if (Sched.overruns(Id))
+      printf("task %u: %u overruns\n", Id, Sched.overruns(Id));
+  if (!timeShown())
+    Status = 1;
+
+  return Status;
+}
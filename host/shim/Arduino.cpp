@@ -0,0 +1,509 @@
+#include <Arduino.h>
+#include <stdio.h>
+#include <map>
+#include <avr/sleep.h>
+#include <avr/wdt.h>
+#include "hostsim.h"
+
+
+/********************/
+/* Module constants */
+/********************/
+
+// Interrupt sources, in vector order: the lowest runs first
+enum Irq_t: uint8_t
+{
+  IrqInt0 = 0U, IrqInt1, IrqPcint0, IrqPcint1, IrqPcint2, IrqTimer1CompA,
+  IrqNum
+};
+
+static const uint8_t _NUM_EXT_INTS = 2U;   // INT0 and INT1
+static const uint16_t _T1_PRESCALERS[8] = { 0U, 1U, 8U, 64U, 256U, 1024U,
+  0U, 0U };  // Per CS1 value, 0 when stopped or external clock
+static const uint16_t _T1_ARMED = 0xFFFFU;  // TCNT1 while it ticks
+static const uint8_t _CPU_MHZ = 16U;
+static const uint16_t _WDT_MS[10] = { 15U, 30U, 60U, 120U, 250U, 500U, 1000U,
+  2000U, 4000U, 8000U };
+
+
+/********************/
+/* Module variables */
+/********************/
+
+// Registers
+HostSreg SREG;
+volatile uint8_t TCCR1A, TCCR1B, TIMSK1, TIFR1;
+volatile uint16_t OCR1A, TCNT1;
+volatile uint8_t PCICR, PCIFR, PCMSK0, PCMSK1, PCMSK2;
+
+HardwareSerial Serial;
+
+static uint64_t _NowUs;          // Virtual time
+static bool _IntsOn = true;      // Global interrupt flag
+static uint8_t _Pending;         // Raised interrupts, a bit per Irq_t
+static uint64_t _T1NextUs;       // Next Timer1 compare match, if armed
+
+// External interrupts
+static void (*_pExtIsrs[_NUM_EXT_INTS])();
+static int _ExtModes[_NUM_EXT_INTS];
+
+// Pins
+static uint8_t _PinModes[NUM_DIGITAL_PINS];
+static uint8_t _PinInputs[NUM_DIGITAL_PINS];   // Driven from outside
+static uint8_t _PinOutputs[NUM_DIGITAL_PINS];  // Written by the firmware
+static unsigned long _PinRises[NUM_DIGITAL_PINS];
+
+// Pin changes driven from outside at a virtual time, in time order
+struct _PinChange_t
+{
+  uint8_t Pin, Level;
+};
+static std::multimap<uint64_t, _PinChange_t> _PinChanges;
+
+// Watchdog
+static bool _WdtOn;
+static uint16_t _WdtMs;
+static uint64_t _WdtKickUs;
+
+static bool _SerialEcho;
+
+
+/********************/
+/* Module functions */
+/********************/
+
+/*
+ *   Runs the raised interrupts while the global interrupt flag is set, with
+ *  it clear during each ISR as the AVR does.
+ */
+static void _dispatch()
+{
+  static void (* const pVectors[IrqNum])() = { INT0_vect, INT1_vect,
+    PCINT0_vect, PCINT1_vect, PCINT2_vect, TIMER1_COMPA_vect };
+
+  while (_IntsOn && _Pending)
+  {
+    uint8_t Irq = 0U;
+
+    while (!(_Pending & _BV(Irq)))
+      Irq++;
+    _Pending &= ~_BV(Irq);
+
+    _IntsOn = false;
+    if (Irq < _NUM_EXT_INTS)
+    {
+      if (_pExtIsrs[Irq])
+        (*_pExtIsrs[Irq])();
+    }
+    else if (pVectors[Irq])
+      (*pVectors[Irq])();
+    _IntsOn = true;
+  }
+}
+
+
+/*
+ *   Raises an interrupt: it runs now if interrupts are enabled, otherwise
+ *  as soon as they are. Raising it again while pending has no effect, like
+ *  the AVR interrupt flags.
+ */
+static void _raise(Irq_t Irq)
+{
+  _Pending |= _BV(Irq);
+  _dispatch();
+}
+
+
+/*
+ *   Returns the Timer1 period in us, 0 when it does not tick.
+ */
+static uint64_t _t1PeriodUs()
+{
+  uint16_t Prescaler = _T1_PRESCALERS[TCCR1B & 0x07U];
+
+  return Prescaler? ((uint64_t) OCR1A + 1U) * Prescaler / _CPU_MHZ: 0U;
+}
+
+
+/*
+ *   Arms the next Timer1 compare match when it has just been started. The
+ *  firmware clears TCNT1 when starting it, while it ticks the shim keeps it
+ *  at _T1_ARMED to tell.
+ */
+static void _t1Arm()
+{
+  uint64_t PeriodUs = _t1PeriodUs();
+
+  if (!PeriodUs)
+    _T1NextUs = 0U;
+  else if (!_T1NextUs || TCNT1 != _T1_ARMED)
+  {
+    _T1NextUs = _NowUs + PeriodUs;
+    TCNT1 = _T1_ARMED;
+  }
+}
+
+
+/***************************/
+/* Status register methods */
+/***************************/
+
+HostSreg::operator uint8_t() const
+{
+  return _IntsOn? _BV(SREG_I): 0U;
+}
+
+
+HostSreg &HostSreg::operator=(uint8_t Value)
+{
+  _IntsOn = Value & _BV(SREG_I);
+  _dispatch();
+
+  return *this;
+}
+
+
+/*****************/
+/* Print methods */
+/*****************/
+
+size_t Print::write(const char *pStr)
+{
+  return write((const uint8_t *) pStr, strlen(pStr));
+}
+
+
+size_t Print::write(const uint8_t *pBuf, size_t Size)
+{
+  for (size_t Idx = 0U; Idx < Size; Idx++)
+    write(pBuf[Idx]);
+
+  return Size;
+}
+
+
+size_t Print::print(const __FlashStringHelper *pStr)
+{
+  return write((const char *) pStr);
+}
+
+
+size_t Print::print(const char *pStr)
+{
+  return write(pStr);
+}
+
+
+size_t Print::print(char Char)
+{
+  return write((uint8_t) Char);
+}
+
+
+size_t Print::print(unsigned char Value, int Base)
+{
+  return _printNumber(Value, Base);
+}
+
+
+size_t Print::print(int Value, int Base)
+{
+  return print((long) Value, Base);
+}
+
+
+size_t Print::print(unsigned int Value, int Base)
+{
+  return _printNumber(Value, Base);
+}
+
+
+size_t Print::print(long Value, int Base)
+{
+  if (Value >= 0L || Base != DEC)
+    return _printNumber(Value, Base);
+
+  return write('-') + _printNumber(-(unsigned long) Value, Base);
+}
+
+
+size_t Print::print(unsigned long Value, int Base)
+{
+  return _printNumber(Value, Base);
+}
+
+
+size_t Print::println()
+{
+  return write("\r\n");
+}
+
+
+size_t Print::_printNumber(unsigned long Value, int Base)
+{
+  char Buf[8 * sizeof Value + 1];
+  char *pChar = Buf + sizeof Buf - 1;
+
+  *pChar = '\0';
+  do
+  {
+    uint8_t Digit = Value % Base;
+
+    *--pChar = Digit < 10U? '0' + Digit: 'A' + Digit - 10U;
+    Value /= Base;
+  } while (Value);
+
+  return write(pChar);
+}
+
+
+size_t HardwareSerial::write(uint8_t Char)
+{
+  if (_SerialEcho && Char != '\r')
+    putchar(Char);
+
+  return 1U;
+}
+
+
+/*****************/
+/* Arduino core */
+/*****************/
+
+void cli()
+{
+  _IntsOn = false;
+}
+
+
+void sei()
+{
+  _IntsOn = true;
+  _dispatch();
+}
+
+
+void pinMode(uint8_t Pin, uint8_t Mode)
+{
+  _PinModes[Pin] = Mode;
+}
+
+
+/*
+ *   Reads a pin: the level driven from outside, HIGH by default as the
+ *  switches are pulled up, or the level written when it is an output.
+ */
+int digitalRead(uint8_t Pin)
+{
+  return _PinModes[Pin] == OUTPUT? _PinOutputs[Pin]: _PinInputs[Pin];
+}
+
+
+void digitalWrite(uint8_t Pin, uint8_t Value)
+{
+  if (Value && !_PinOutputs[Pin])
+    _PinRises[Pin]++;
+  _PinOutputs[Pin] = Value? HIGH: LOW;
+}
+
+
+unsigned long millis()
+{
+  return _NowUs / 1000U;
+}
+
+
+unsigned long micros()
+{
+  return _NowUs;
+}
+
+
+void delay(unsigned long Ms)
+{
+  hostAdvance(Ms * 1000ULL);
+}
+
+
+void delayMicroseconds(unsigned int Us)
+{
+  hostAdvance(Us);
+}
+
+
+void attachInterrupt(uint8_t Interrupt, void (*pIsr)(), int Mode)
+{
+  if (Interrupt < _NUM_EXT_INTS)
+  {
+    _pExtIsrs[Interrupt] = pIsr;
+    _ExtModes[Interrupt] = Mode;
+  }
+}
+
+
+void detachInterrupt(uint8_t Interrupt)
+{
+  if (Interrupt < _NUM_EXT_INTS)
+    _pExtIsrs[Interrupt] = nullptr;
+}
+
+
+/*
+ *   Idle sleep: Timer0 wakes the CPU up every ms at most.
+ */
+void sleep_cpu()
+{
+  hostAdvance(1000U - _NowUs % 1000U);
+}
+
+
+void wdt_enable(uint8_t Timeout)
+{
+  _WdtOn = true;
+  _WdtMs = _WDT_MS[Timeout];
+  _WdtKickUs = _NowUs;
+}
+
+
+void wdt_disable()
+{
+  _WdtOn = false;
+}
+
+
+void wdt_reset()
+{
+  _WdtKickUs = _NowUs;
+}
+
+
+/*******************/
+/* Harness control */
+/*******************/
+
+uint64_t hostMicros()
+{
+  return _NowUs;
+}
+
+
+void hostAdvance(uint64_t Us)
+{
+  hostAdvanceTo(_NowUs + Us);
+}
+
+
+/*
+ *   Moves virtual time forward, firing the Timer1 compare matches and
+ *  applying the pin changes due on the way. Ends the program if the watchdog
+ *  expires.
+ */
+void hostAdvanceTo(uint64_t Us)
+{
+  _dispatch();
+
+  while (_NowUs < Us)
+  {
+    uint64_t NextUs = Us;
+
+    _t1Arm();
+    if (_T1NextUs && _T1NextUs < NextUs)
+      NextUs = _T1NextUs;
+    if (!_PinChanges.empty() && _PinChanges.begin()->first < NextUs)
+      NextUs = _PinChanges.begin()->first;
+    _NowUs = NextUs;
+
+    if (_T1NextUs && _T1NextUs <= _NowUs)
+    {
+      _T1NextUs += _t1PeriodUs();
+      if (TIMSK1 & _BV(OCIE1A))
+        _raise(IrqTimer1CompA);
+    }
+    while (!_PinChanges.empty() && _PinChanges.begin()->first <= _NowUs)
+    {
+      _PinChange_t Change = _PinChanges.begin()->second;
+
+      _PinChanges.erase(_PinChanges.begin());
+      hostSetPin(Change.Pin, Change.Level);
+    }
+
+    if (_WdtOn && _NowUs - _WdtKickUs >= _WdtMs * 1000ULL)
+    {
+      fflush(stdout);
+      fprintf(stderr, "watchdog reset at %llu us\n",
+        (unsigned long long) _NowUs);
+      exit(HOST_EXIT_WATCHDOG);
+    }
+  }
+}
+
+
+/*
+ *   Drives an input pin from outside, raising the interrupts it is wired to:
+ *  INT0 and INT1 on pins 2 and 3, pin change interrupts on the rest.
+ */
+void hostSetPin(uint8_t Pin, uint8_t Level)
+{
+  int Interrupt = digitalPinToInterrupt(Pin);
+  bool Rising = Level && !_PinInputs[Pin];
+
+  Level = Level? HIGH: LOW;
+  if (Level == _PinInputs[Pin])
+    return;
+  _PinInputs[Pin] = Level;
+
+  if (Interrupt >= 0)
+  {
+    int Mode = _ExtModes[Interrupt];
+
+    if (_pExtIsrs[Interrupt] && (Mode == CHANGE ||
+        (Mode == RISING && Rising) || (Mode == FALLING && !Rising)))
+      _raise((Irq_t) (IrqInt0 + Interrupt));
+  }
+  else if ((PCICR & _BV(digitalPinToPCICRbit(Pin))) &&
+      (*digitalPinToPCMSK(Pin) & _BV(digitalPinToPCMSKbit(Pin))))
+    _raise((Irq_t) (IrqPcint0 + digitalPinToPCICRbit(Pin)));
+}
+
+
+/*
+ *   Drives an input pin from outside when virtual time reaches a given one,
+ *  at once if already past. Changes at the same time apply in the order set.
+ */
+void hostSetPinAt(uint64_t Us, uint8_t Pin, uint8_t Level)
+{
+  if (Us <= _NowUs)
+    hostSetPin(Pin, Level);
+  else
+    _PinChanges.insert(std::make_pair(Us, _PinChange_t{ Pin, Level }));
+}
+
+
+uint8_t hostPinOutput(uint8_t Pin)
+{
+  return _PinOutputs[Pin];
+}
+
+
+unsigned long hostPinRises(uint8_t Pin)
+{
+  return _PinRises[Pin];
+}
+
+
+void hostSerialEcho(bool Echo)
+{
+  _SerialEcho = Echo;
+}
+
+
+/*
+ *   Pins start pulled up, as the switches are open.
+ */
+static struct HostPinsInit
+{
+  HostPinsInit()
+  {
+    memset(_PinInputs, HIGH, sizeof _PinInputs);
+  }
+} _HostPinsInit;
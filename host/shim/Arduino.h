@@ -0,0 +1,158 @@
+#ifndef _ARDUINO_H_
+#define _ARDUINO_H_
+
+/*
+ *   Host stand-in for the Arduino core of the Nano (ATmega328P), enough to
+ *  build the firmware in src/ unmodified. Time is virtual: it only moves
+ *  when the firmware waits (delay(), sleep_cpu()) or a harness advances it
+ *  (see hostsim.h), firing the interrupts due on the way.
+ */
+
+#include <stdint.h>
+#include <stddef.h>
+#include <stdlib.h>
+#include <string.h>
+#include <math.h>
+#include <avr/pgmspace.h>
+#include <avr/io.h>
+#include <avr/interrupt.h>
+
+
+/*************/
+/* Constants */
+/*************/
+
+#define HIGH 0x1
+#define LOW 0x0
+
+#define INPUT 0x0
+#define OUTPUT 0x1
+#define INPUT_PULLUP 0x2
+
+#define CHANGE 1
+#define FALLING 2
+#define RISING 3
+
+// Nano analog pins, usable as digital ones
+#define A0 14
+#define A1 15
+#define A2 16
+#define A3 17
+#define A4 18
+#define A5 19
+#define NUM_DIGITAL_PINS 20
+
+#define bitRead(value, bit) (((value) >> (bit)) & 0x01)
+#define bitSet(value, bit) ((value) |= (1UL << (bit)))
+#define bitClear(value, bit) ((value) &= ~(1UL << (bit)))
+
+#define interrupts() sei()
+#define noInterrupts() cli()
+
+// ATmega328P pin mapping: external interrupts on pins 2 and 3, pin change
+// groups PCINT2 (0-7), PCINT0 (8-13) and PCINT1 (A0-A5)
+#define digitalPinToInterrupt(p) ((p) == 2? 0: ((p) == 3? 1: -1))
+#define digitalPinToPCICR(p) (((p) >= 0 && (p) <= 21)? (&PCICR): \
+  ((uint8_t *) 0))
+#define digitalPinToPCICRbit(p) (((p) <= 7)? 2: (((p) <= 13)? 0: 1))
+#define digitalPinToPCMSK(p) (((p) <= 7)? (&PCMSK2): (((p) <= 13)? \
+  (&PCMSK0): (((p) <= 21)? (&PCMSK1): ((uint8_t *) 0))))
+#define digitalPinToPCMSKbit(p) (((p) <= 7)? (p): (((p) <= 13)? ((p) - 8): \
+  ((p) - 14)))
+
+typedef uint8_t byte;
+typedef bool boolean;
+
+
+/*********/
+/* Print */
+/*********/
+
+// Flash strings are plain strings on the host
+class __FlashStringHelper;
+#define F(string_literal) \
+  (reinterpret_cast<const __FlashStringHelper *>(PSTR(string_literal)))
+
+#define DEC 10
+#define HEX 16
+
+/*
+ *   Base of the character outputs, as in the Arduino core: derived classes
+ *  only implement write(uint8_t).
+ */
+class Print
+{
+public:
+  virtual ~Print() {}
+  virtual size_t write(uint8_t Char) = 0;
+  size_t write(const char *pStr);
+  size_t write(const uint8_t *pBuf, size_t Size);
+  size_t write(char Char) { return write((uint8_t) Char); }
+
+  size_t print(const __FlashStringHelper *pStr);
+  size_t print(const char *pStr);
+  size_t print(char Char);
+  size_t print(unsigned char Value, int Base = DEC);
+  size_t print(int Value, int Base = DEC);
+  size_t print(unsigned int Value, int Base = DEC);
+  size_t print(long Value, int Base = DEC);
+  size_t print(unsigned long Value, int Base = DEC);
+  size_t println();
+  template <class T> size_t println(T Value);
+  template <class T> size_t println(T Value, int Base);
+
+protected:
+  size_t _printNumber(unsigned long Value, int Base);
+};
+
+template <class T> size_t Print::println(T Value)
+{
+  size_t Size = print(Value);
+
+  return Size + println();
+}
+
+template <class T> size_t Print::println(T Value, int Base)
+{
+  size_t Size = print(Value, Base);
+
+  return Size + println();
+}
+
+
+/*
+ *   Serial port: goes to stdout when echo is on (see hostsim.h).
+ */
+class HardwareSerial: public Print
+{
+public:
+  void begin(unsigned long Baud) { (void) Baud; }
+  void end() {}
+  operator bool() { return true; }
+  virtual size_t write(uint8_t Char);
+  using Print::write;
+};
+
+extern HardwareSerial Serial;
+
+
+/*************/
+/* Functions */
+/*************/
+
+void pinMode(uint8_t Pin, uint8_t Mode);
+int digitalRead(uint8_t Pin);
+void digitalWrite(uint8_t Pin, uint8_t Value);
+unsigned long millis();
+unsigned long micros();
+void delay(unsigned long Ms);
+void delayMicroseconds(unsigned int Us);
+void attachInterrupt(uint8_t Interrupt, void (*pIsr)(), int Mode);
+void detachInterrupt(uint8_t Interrupt);
+
+// Sketch entry points
+void setup();
+void loop();
+
+
+#endif  // _ARDUINO_H_
@@ -0,0 +1,72 @@
+#include <EEPROM.h>
+#include "hostsim.h"
+
+
+/********************/
+/* Module constants */
+/********************/
+
+static const uint16_t _WRITE_US = 3400U;  // Erase and write of a byte
+
+
+/********************/
+/* Module variables */
+/********************/
+
+EEPROMClass EEPROM;
+
+static uint8_t _Bytes[EEPROMClass::SIZE];
+static unsigned long _Writes;  // Byte writes, the wear of the EEPROM
+
+
+/***********/
+/* Methods */
+/***********/
+
+uint8_t EEPROMClass::read(int Addr)
+{
+  return _Bytes[Addr % SIZE];
+}
+
+
+void EEPROMClass::write(int Addr, uint8_t Value)
+{
+  _Bytes[Addr % SIZE] = Value;
+  _Writes++;
+  hostAdvance(_WRITE_US);
+}
+
+
+void EEPROMClass::update(int Addr, uint8_t Value)
+{
+  if (read(Addr) != Value)
+    write(Addr, Value);
+}
+
+
+/*******************/
+/* Harness control */
+/*******************/
+
+void hostEepromErase()
+{
+  memset(_Bytes, 0xFF, sizeof _Bytes);
+}
+
+
+unsigned long hostEepromWrites()
+{
+  return _Writes;
+}
+
+
+/*
+ *   The EEPROM comes erased.
+ */
+static struct HostEepromInit
+{
+  HostEepromInit()
+  {
+    hostEepromErase();
+  }
+} _HostEepromInit;
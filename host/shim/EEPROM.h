@@ -0,0 +1,54 @@
+#ifndef _EEPROM_H_
+#define _EEPROM_H_
+
+/*
+ *   Host stand-in for the Arduino EEPROM library: 1KB in RAM, erased
+ *  (0xFF) at start. Byte writes take the 3.4 ms of virtual time of the AVR,
+ *  busy waiting, and are counted, to compare the wear of storage changes
+ *  (see hostsim.h).
+ */
+
+#include <Arduino.h>
+
+
+class EEPROMClass
+{
+public:
+  uint8_t read(int Addr);
+  void write(int Addr, uint8_t Value);
+  void update(int Addr, uint8_t Value);
+  uint16_t length() { return SIZE; }
+
+  // Byte by byte, like the Arduino library: put() only writes the changes
+  template <class T> T &get(int Addr, T &Data);
+  template <class T> const T &put(int Addr, const T &Data);
+
+  static const uint16_t SIZE = 1024U;
+};
+
+extern EEPROMClass EEPROM;
+
+
+template <class T> T &EEPROMClass::get(int Addr, T &Data)
+{
+  uint8_t *pByte = (uint8_t *) &Data;
+
+  for (size_t Idx = 0U; Idx < sizeof Data; Idx++)
+    *pByte++ = read(Addr++);
+
+  return Data;
+}
+
+
+template <class T> const T &EEPROMClass::put(int Addr, const T &Data)
+{
+  const uint8_t *pByte = (const uint8_t *) &Data;
+
+  for (size_t Idx = 0U; Idx < sizeof Data; Idx++)
+    update(Addr++, *pByte++);
+
+  return Data;
+}
+
+
+#endif  // _EEPROM_H_
@@ -0,0 +1,79 @@
+#include <LiquidCrystal.h>
+#include "hostsim.h"
+
+
+/********************/
+/* Module constants */
+/********************/
+
+static const uint8_t _MAX_COLS = 40U;  // HD44780 line memory
+static const uint8_t _MAX_ROWS = 4U;
+
+
+/********************/
+/* Module variables */
+/********************/
+
+static char _Lines[_MAX_ROWS][_MAX_COLS + 1];
+static uint8_t _Cols = 16U, _Rows = 2U;
+static uint8_t _Col, _Row;  // Cursor
+
+
+/***********/
+/* Methods */
+/***********/
+
+LiquidCrystal::LiquidCrystal(uint8_t Rs, uint8_t Enable, uint8_t D4,
+  uint8_t D5, uint8_t D6, uint8_t D7)
+{
+  (void) Rs; (void) Enable; (void) D4; (void) D5; (void) D6; (void) D7;
+}
+
+
+void LiquidCrystal::begin(uint8_t Cols, uint8_t Rows)
+{
+  _Cols = Cols < _MAX_COLS? Cols: _MAX_COLS;
+  _Rows = Rows < _MAX_ROWS? Rows: _MAX_ROWS;
+  clear();
+}
+
+
+void LiquidCrystal::clear()
+{
+  for (uint8_t Row = 0U; Row < _MAX_ROWS; Row++)
+  {
+    memset(_Lines[Row], ' ', _Cols);
+    _Lines[Row][_Cols] = '\0';
+  }
+  _Col = _Row = 0U;
+}
+
+
+void LiquidCrystal::setCursor(uint8_t Col, uint8_t Row)
+{
+  _Col = Col;
+  _Row = Row < _Rows? Row: _Rows - 1U;
+}
+
+
+/*
+ *   Writes a character at the cursor and moves it right. Characters past
+ *  the last column are lost.
+ */
+size_t LiquidCrystal::write(uint8_t Char)
+{
+  if (_Col < _Cols)
+    _Lines[_Row][_Col++] = Char;
+
+  return 1U;
+}
+
+
+/*******************/
+/* Harness control */
+/*******************/
+
+const char *hostLcdLine(uint8_t Row)
+{
+  return _Lines[Row < _Rows? Row: 0U];
+}
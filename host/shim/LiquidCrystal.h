@@ -0,0 +1,27 @@
+#ifndef _LIQUIDCRYSTAL_H_
+#define _LIQUIDCRYSTAL_H_
+
+/*
+ *   Host stand-in for the Arduino LiquidCrystal library: the characters
+ *  written go to a text buffer of the display, readable with hostLcdLine()
+ *  (see hostsim.h). Only one display can exist.
+ */
+
+#include <Arduino.h>
+
+
+class LiquidCrystal: public Print
+{
+public:
+  LiquidCrystal(uint8_t Rs, uint8_t Enable, uint8_t D4, uint8_t D5,
+    uint8_t D6, uint8_t D7);
+  void begin(uint8_t Cols, uint8_t Rows);
+  void clear();
+  void home() { setCursor(0U, 0U); }
+  void setCursor(uint8_t Col, uint8_t Row);
+  virtual size_t write(uint8_t Char);
+  using Print::write;
+};
+
+
+#endif  // _LIQUIDCRYSTAL_H_
@@ -0,0 +1,60 @@
+#include <REncoder.h>
+
+
+/********************/
+/* Module constants */
+/********************/
+
+static const uint8_t _REST = 0x03U;  // Both pins HIGH
+static const int8_t _QUARTERS_PER_DETENT = 4;
+
+// Position of each state (A << 1 | B) in the clockwise cycle 11, 01, 00, 10
+static const uint8_t _POSITIONS[4] = { 2U, 1U, 3U, 0U };
+
+
+/***********/
+/* Methods */
+/***********/
+
+REncoder::REncoder():
+  _State(_REST),
+  _Quarters(0)
+{
+}
+
+
+/*
+ *   Decodes a change of the pins.
+ *  Parameters:
+ *  * A, B: levels of the encoder pins.
+ *  Returns: 1 when a clockwise detent is completed, -1 when a counter
+ *  clockwise one is and 0 otherwise.
+ */
+int8_t REncoder::update(uint8_t A, uint8_t B)
+{
+  uint8_t State = (A? 2U: 0U) | (B? 1U: 0U);
+  int8_t Step = 0;
+
+  // One position forward or back. Two means a missed state: ignored
+  switch ((_POSITIONS[State] - _POSITIONS[_State]) & 0x03U)
+  {
+  case 1U:
+    _Quarters++;
+    break;
+  case 3U:
+    _Quarters--;
+    break;
+  }
+  _State = State;
+
+  if (State == _REST)
+  {
+    if (_Quarters >= _QUARTERS_PER_DETENT)
+      Step = 1;
+    else if (_Quarters <= -_QUARTERS_PER_DETENT)
+      Step = -1;
+    _Quarters = 0;
+  }
+
+  return Step;
+}
@@ -0,0 +1,26 @@
+#ifndef _RENCODER_H_
+#define _RENCODER_H_
+
+/*
+ *   Host stand-in for the REncoder library: full step quadrature decoder.
+ *  A detent is reported when the encoder gets back to the rest state (both
+ *  pins HIGH) after a whole cycle in one direction, so contact bounce on one
+ *  pin cancels out.
+ */
+
+#include <Arduino.h>
+
+
+class REncoder
+{
+public:
+  REncoder();
+  int8_t update(uint8_t A, uint8_t B);
+
+protected:
+  uint8_t _State;   // Last A and B levels, A in bit 1
+  int8_t _Quarters; // Quarter steps since the rest state, clockwise positive
+};
+
+
+#endif  // _RENCODER_H_
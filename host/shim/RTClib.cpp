@@ -0,0 +1,216 @@
+#include <RTClib.h>
+#include "hostsim.h"
+
+
+/********************/
+/* Module constants */
+/********************/
+
+static const uint32_t _SECONDS_PER_DAY = 86400UL;
+static const uint8_t _DAYS_IN_MONTH[12] = { 31U, 28U, 31U, 30U, 31U, 30U,
+  31U, 31U, 30U, 31U, 30U, 31U };
+
+
+/********************/
+/* Module variables */
+/********************/
+
+static bool _RtcRunning;
+static uint32_t _RtcBase;      // Unix time when adjusted
+static uint64_t _RtcBaseUs;    // Virtual time when adjusted
+static unsigned long _RtcReads;
+
+
+/********************/
+/* Module functions */
+/********************/
+
+/*
+ *   Returns the days from 2000-01-01 to a date from 2000 to 2099.
+ */
+static uint16_t _daysFrom2000(uint16_t Year, uint8_t Month, uint8_t Day)
+{
+  uint16_t Days = Day - 1U;
+
+  if (Year >= 2000U)
+    Year -= 2000U;
+  for (uint8_t Idx = 1U; Idx < Month; Idx++)
+    Days += _DAYS_IN_MONTH[Idx - 1U];
+  if (Month > 2U && Year % 4U == 0U)
+    Days++;
+
+  return Days + 365U * Year + (Year + 3U) / 4U;
+}
+
+
+/********************/
+/* TimeSpan methods */
+/********************/
+
+TimeSpan::TimeSpan(int32_t Seconds):
+  _Seconds(Seconds)
+{
+}
+
+
+TimeSpan::TimeSpan(int16_t Days, int8_t Hours, int8_t Minutes,
+    int8_t Seconds):
+  _Seconds(Days * 86400L + Hours * 3600L + Minutes * 60L + Seconds)
+{
+}
+
+
+TimeSpan TimeSpan::operator+(const TimeSpan &Right)
+{
+  return TimeSpan(_Seconds + Right._Seconds);
+}
+
+
+TimeSpan TimeSpan::operator-(const TimeSpan &Right)
+{
+  return TimeSpan(_Seconds - Right._Seconds);
+}
+
+
+/********************/
+/* DateTime methods */
+/********************/
+
+DateTime::DateTime(uint32_t UnixTime)
+{
+  uint32_t Time = UnixTime - SECONDS_FROM_1970_TO_2000;
+  uint16_t Days;
+  uint8_t Leap;
+
+  _Ss = Time % 60UL;
+  Time /= 60UL;
+  _Mm = Time % 60UL;
+  Time /= 60UL;
+  _Hh = Time % 24UL;
+  Days = Time / 24UL;
+
+  for (_YOff = 0U; ; _YOff++)
+  {
+    Leap = _YOff % 4U == 0U;
+    if (Days < 365U + Leap)
+      break;
+    Days -= 365U + Leap;
+  }
+  for (_M = 1U; ; _M++)
+  {
+    uint8_t MonthDays = _DAYS_IN_MONTH[_M - 1U] + (Leap && _M == 2U);
+
+    if (Days < MonthDays)
+      break;
+    Days -= MonthDays;
+  }
+  _D = Days + 1U;
+}
+
+
+DateTime::DateTime(uint16_t Year, uint8_t Month, uint8_t Day, uint8_t Hour,
+    uint8_t Minute, uint8_t Second):
+  _YOff(Year >= 2000U? Year - 2000U: Year),
+  _M(Month),
+  _D(Day),
+  _Hh(Hour),
+  _Mm(Minute),
+  _Ss(Second)
+{
+}
+
+
+/*
+ *   Returns the day of the week, 0 being Sunday. 2000-01-01 was a Saturday.
+ */
+uint8_t DateTime::dayOfTheWeek() const
+{
+  return (_daysFrom2000(_YOff, _M, _D) + 6U) % 7U;
+}
+
+
+uint32_t DateTime::unixtime() const
+{
+  return SECONDS_FROM_1970_TO_2000 +
+    _daysFrom2000(_YOff, _M, _D) * _SECONDS_PER_DAY +
+    _Hh * 3600UL + _Mm * 60UL + _Ss;
+}
+
+
+DateTime DateTime::operator+(const TimeSpan &Span)
+{
+  return DateTime(unixtime() + Span.totalseconds());
+}
+
+
+DateTime DateTime::operator-(const TimeSpan &Span)
+{
+  return DateTime(unixtime() - Span.totalseconds());
+}
+
+
+TimeSpan DateTime::operator-(const DateTime &Right)
+{
+  return TimeSpan(unixtime() - Right.unixtime());
+}
+
+
+bool DateTime::operator<(const DateTime &Right) const
+{
+  return unixtime() < Right.unixtime();
+}
+
+
+bool DateTime::operator==(const DateTime &Right) const
+{
+  return unixtime() == Right.unixtime();
+}
+
+
+/**********************/
+/* RTC_DS1307 methods */
+/**********************/
+
+void RTC_DS1307::adjust(const DateTime &Time)
+{
+  hostRtcSet(Time.unixtime());
+}
+
+
+uint8_t RTC_DS1307::isrunning()
+{
+  return _RtcRunning;
+}
+
+
+/*
+ *   Returns the time, in whole seconds as the DS1307 has no finer
+ *  resolution. Stopped at 2000-01-01 until adjusted.
+ */
+DateTime RTC_DS1307::now()
+{
+  _RtcReads++;
+  if (!_RtcRunning)
+    return DateTime();
+
+  return DateTime(_RtcBase + (uint32_t) ((hostMicros() - _RtcBaseUs) /
+    1000000ULL));
+}
+
+
+/*******************/
+/* Harness control */
+/*******************/
+
+void hostRtcSet(uint32_t UnixTime)
+{
+  _RtcRunning = true;
+  _RtcBase = UnixTime;
+  _RtcBaseUs = hostMicros();
+}
+
+
+unsigned long hostRtcReads()
+{
+  return _RtcReads;
+}
@@ -0,0 +1,86 @@
+#ifndef _RTCLIB_H_
+#define _RTCLIB_H_
+
+/*
+ *   Host stand-in for the parts of Adafruit's RTClib used by the firmware,
+ *  with the same semantics: dates from 2000 to 2099, Unix times, Sunday as
+ *  day of the week 0. The DS1307 runs on virtual time and counts its reads
+ *  (see hostsim.h).
+ */
+
+#include <Arduino.h>
+
+
+/*
+ *   Signed time interval in seconds.
+ */
+class TimeSpan
+{
+public:
+  TimeSpan(int32_t Seconds = 0);
+  TimeSpan(int16_t Days, int8_t Hours, int8_t Minutes, int8_t Seconds);
+  int16_t days() const { return _Seconds / 86400L; }
+  int8_t hours() const { return _Seconds / 3600L % 24L; }
+  int8_t minutes() const { return _Seconds / 60L % 60L; }
+  int8_t seconds() const { return _Seconds % 60L; }
+  int32_t totalseconds() const { return _Seconds; }
+  TimeSpan operator+(const TimeSpan &Right);
+  TimeSpan operator-(const TimeSpan &Right);
+
+protected:
+  int32_t _Seconds;
+};
+
+
+/*
+ *   Date and time, without time zone.
+ */
+class DateTime
+{
+public:
+  DateTime(uint32_t UnixTime = SECONDS_FROM_1970_TO_2000);
+  DateTime(uint16_t Year, uint8_t Month, uint8_t Day, uint8_t Hour = 0U,
+    uint8_t Minute = 0U, uint8_t Second = 0U);
+  uint16_t year() const { return 2000U + _YOff; }
+  uint8_t month() const { return _M; }
+  uint8_t day() const { return _D; }
+  uint8_t hour() const { return _Hh; }
+  uint8_t minute() const { return _Mm; }
+  uint8_t second() const { return _Ss; }
+  uint8_t dayOfTheWeek() const;
+  uint32_t unixtime() const;
+
+  // Not const, as in RTClib
+  DateTime operator+(const TimeSpan &Span);
+  DateTime operator-(const TimeSpan &Span);
+  TimeSpan operator-(const DateTime &Right);
+
+  bool operator<(const DateTime &Right) const;
+  bool operator>(const DateTime &Right) const { return Right < *this; }
+  bool operator<=(const DateTime &Right) const { return !(*this > Right); }
+  bool operator>=(const DateTime &Right) const { return !(*this < Right); }
+  bool operator==(const DateTime &Right) const;
+  bool operator!=(const DateTime &Right) const { return !(*this == Right); }
+
+  static const uint32_t SECONDS_FROM_1970_TO_2000 = 946684800UL;
+
+protected:
+  uint8_t _YOff, _M, _D, _Hh, _Mm, _Ss;
+};
+
+
+/*
+ *   DS1307 real time clock. It does not tick until it is first adjusted, as
+ *  a new one.
+ */
+class RTC_DS1307
+{
+public:
+  bool begin() { return true; }
+  static void adjust(const DateTime &Time);
+  uint8_t isrunning();
+  static DateTime now();
+};
+
+
+#endif  // _RTCLIB_H_
@@ -0,0 +1,27 @@
+#ifndef _AVR_INTERRUPT_H_
+#define _AVR_INTERRUPT_H_
+
+/*
+ *   Host stand-in for avr-libc interrupt handling. ISRs are plain functions
+ *  called by the shim when their interrupt is raised and the global
+ *  interrupt flag in SREG is set, lowest vector first, as the AVR does.
+ *  Vectors the firmware does not define are never called.
+ */
+
+#define ISR(vector, ...) extern "C" void vector(void)
+
+void cli();
+void sei();
+
+extern "C"
+{
+void INT0_vect(void) __attribute__((weak));
+void INT1_vect(void) __attribute__((weak));
+void PCINT0_vect(void) __attribute__((weak));
+void PCINT1_vect(void) __attribute__((weak));
+void PCINT2_vect(void) __attribute__((weak));
+void TIMER1_COMPA_vect(void) __attribute__((weak));
+}
+
+
+#endif  // _AVR_INTERRUPT_H_
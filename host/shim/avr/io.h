@@ -0,0 +1,53 @@
+#ifndef _AVR_IO_H_
+#define _AVR_IO_H_
+
+/*
+ *   Host stand-in for the ATmega328P registers used by the firmware: the
+ *  status register, Timer1 and the pin change interrupts. Timer1 ticks on
+ *  virtual time with the prescaler and OCR1A set (CTC mode), and the pin
+ *  change groups follow PCICR and the PCMSKn masks.
+ */
+
+#include <stdint.h>
+
+#define _BV(bit) (1U << (bit))
+
+
+/*
+ *   Status register. Only the global interrupt flag is kept: setting it
+ *  runs the interrupts raised while it was clear.
+ */
+class HostSreg
+{
+public:
+  operator uint8_t() const;
+  HostSreg &operator=(uint8_t Value);
+};
+
+extern HostSreg SREG;
+#define SREG_I 7
+
+extern volatile uint8_t TCCR1A, TCCR1B, TIMSK1, TIFR1;
+extern volatile uint16_t OCR1A, TCNT1;
+extern volatile uint8_t PCICR, PCIFR, PCMSK0, PCMSK1, PCMSK2;
+
+// TCCR1B
+#define CS10 0
+#define CS11 1
+#define CS12 2
+#define WGM12 3
+// TIMSK1, TIFR1
+#define OCIE1A 1
+#define OCF1A 1
+// PCICR, PCIFR
+#define PCIE0 0
+#define PCIE1 1
+#define PCIE2 2
+#define PCIF0 0
+#define PCIF1 1
+#define PCIF2 2
+
+#define RAMEND 0x8FF
+
+
+#endif  // _AVR_IO_H_
@@ -0,0 +1,15 @@
+#ifndef _AVR_POWER_H_
+#define _AVR_POWER_H_
+
+/*
+ *   Host stand-in for avr-libc power reduction: nothing to power down.
+ */
+
+#define power_adc_disable()
+#define power_spi_disable()
+#define power_timer2_disable()
+#define power_twi_disable()
+#define power_usart0_disable()
+
+
+#endif  // _AVR_POWER_H_
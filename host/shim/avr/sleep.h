@@ -0,0 +1,21 @@
+#ifndef _AVR_SLEEP_H_
+#define _AVR_SLEEP_H_
+
+/*
+ *   Host stand-in for avr-libc sleep modes. sleep_cpu() in idle mode waits
+ *  for the next Timer0 tick, the next ms of virtual time, firing the
+ *  interrupts due on the way.
+ */
+
+#define SLEEP_MODE_IDLE 0
+#define SLEEP_MODE_PWR_DOWN 2
+#define SLEEP_MODE_PWR_SAVE 3
+
+#define set_sleep_mode(mode)
+#define sleep_enable()
+#define sleep_disable()
+
+void sleep_cpu();
+
+
+#endif  // _AVR_SLEEP_H_
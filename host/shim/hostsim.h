@@ -0,0 +1,44 @@
+#ifndef _HOSTSIM_H_
+#define _HOSTSIM_H_
+
+/*
+ *   Control of the host shim by the harnesses: the virtual time, the input
+ *  pins, the RTC, the EEPROM and what the firmware shows or prints. Time
+ *  starts at 0 with interrupts enabled, as after the Arduino init().
+ */
+
+#include <Arduino.h>
+
+
+// Virtual time
+uint64_t hostMicros();
+void hostAdvance(uint64_t Us);
+void hostAdvanceTo(uint64_t Us);
+
+// Pins: level driven from outside, now or when virtual time reaches a given
+// one (even while the firmware runs), level written by the firmware and
+// rising edges it wrote (steps of a stepper driver)
+void hostSetPin(uint8_t Pin, uint8_t Level);
+void hostSetPinAt(uint64_t Us, uint8_t Pin, uint8_t Level);
+uint8_t hostPinOutput(uint8_t Pin);
+unsigned long hostPinRises(uint8_t Pin);
+
+// Real time clock: set it running at a Unix time, and reads since start
+void hostRtcSet(uint32_t UnixTime);
+unsigned long hostRtcReads();
+
+// EEPROM: erase it all, and byte writes since start
+void hostEepromErase();
+unsigned long hostEepromWrites();
+
+// Display line, as many characters as columns
+const char *hostLcdLine(uint8_t Row);
+
+// Serial output to stdout, off by default
+void hostSerialEcho(bool Echo);
+
+// Status the program exits with when the watchdog expires
+static const int HOST_EXIT_WATCHDOG = 3;
+
+
+#endif  // _HOSTSIM_H_
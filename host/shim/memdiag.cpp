@@ -0,0 +1,74 @@
+#include "config.h"
+#include "memdiag.h"
+
+
+/*
+ *   Host version of the SRAM report: the SRAM layout of the Nano does not
+ *  exist on the host, so the figures are fixed ones, like those of a Nano
+ *  (2048 bytes, .data + .bss + free minimum + stack maximum), all different
+ *  so the display can be checked. It replaces src/memdiag.cpp, whose stack
+ *  painting is AVR assembler.
+ */
+
+
+/********************/
+/* Module constants */
+/********************/
+
+static const uint16_t _DATA_SIZE = 214U;
+static const uint16_t _BSS_SIZE = 1083U;
+static const uint16_t _STACK_MAX = 367U;
+static const uint16_t _FREE_NOW = 512U;
+static const uint16_t _FREE_MIN = 384U;
+
+
+/***********/
+/* Methods */
+/***********/
+
+uint16_t MemDiag::dataSize()
+{
+  return _DATA_SIZE;
+}
+
+
+uint16_t MemDiag::bssSize()
+{
+  return _BSS_SIZE;
+}
+
+
+uint16_t MemDiag::stackMax()
+{
+  return _STACK_MAX;
+}
+
+
+uint16_t MemDiag::freeNow()
+{
+  return _FREE_NOW;
+}
+
+
+uint16_t MemDiag::freeMin()
+{
+  return _FREE_MIN;
+}
+
+
+void MemDiag::report(Report_t *pReport)
+{
+  pReport->DataSize = _DATA_SIZE;
+  pReport->BssSize = _BSS_SIZE;
+  pReport->StackMax = _STACK_MAX;
+  pReport->FreeNow = _FREE_NOW;
+  pReport->FreeMin = _FREE_MIN;
+}
+
+
+#ifdef ENABLE_DIAG_SERIAL
+void MemDiag::print(Print &Out)
+{
+  Out.println(F("data=214 bss=1083 stackmax=367 freenow=512 freemin=384"));
+}
+#endif  // ENABLE_DIAG_SERIAL
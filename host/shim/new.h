@@ -0,0 +1,11 @@
+#ifndef _NEW_H_
+#define _NEW_H_
+
+/*
+ *   Placement new, from the standard library on the host.
+ */
+
+#include <new>
+
+
+#endif  // _NEW_H_
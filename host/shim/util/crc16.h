@@ -0,0 +1,21 @@
+#ifndef _UTIL_CRC16_H_
+#define _UTIL_CRC16_H_
+
+/*
+ *   Host version of the avr-libc CRC-16 (polynomial 0xA001), the equivalent
+ *  C code given in its documentation.
+ */
+
+#include <stdint.h>
+
+static inline uint16_t _crc16_update(uint16_t Crc, uint8_t Data)
+{
+  Crc ^= Data;
+  for (uint8_t Bit = 0U; Bit < 8U; Bit++)
+    Crc = Crc & 1U? (Crc >> 1) ^ 0xA001U: Crc >> 1;
+
+  return Crc;
+}
+
+
+#endif  // _UTIL_CRC16_H_
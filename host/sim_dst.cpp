@@ -0,0 +1,517 @@
+/*
+ *   Year long meal schedule simulation: runs the real Feeds, Clock and
+ *  Scheduler through one or more simulated years on virtual time, with the
+ *  time and meal check tasks of the sketch, for many random meal
+ *  configurations and some fixed hard ones around the DST changes. Every
+ *  meal must be served (or skipped) exactly once, within its minute or, in
+ *  the hour skipped when DST starts, as soon as it is over. That is checked
+ *  against an independent calculation of the EU DST rules.
+ *   It reports the host time spent in the scheduler per simulated day, the
+ *  task runs and the RTC reads. Virtual time jumps from one task run to the
+ *  next, as the loop of the sketch would just sleep in between.
+ *  Usage: sim_dst [--years N] [--configs N] [--seed N] [--verbose]
+ *  Exits with 1 when a meal is missed, repeated, late or wrong.
+ */
+
+#include "config.h"
+#include <stdio.h>
+#include <chrono>
+#include <random>
+#include <vector>
+#include <algorithm>
+#include <RTClib.h>
+#include "dotwutil.h"
+#include "feeds.h"
+#include "clock.h"
+#include "scheduler.h"
+#include "hostsim.h"
+
+
+/*************/
+/* Constants */
+/*************/
+
+enum TaskId_t: uint8_t
+{
+  TkTime = 0U, TkFeed, TkNum
+};
+
+static const uint64_t US_PER_S = 1000000ULL;
+static const int64_t SECONDS_PER_DAY = 86400LL;
+static const int64_t SECONDS_PER_HOUR = 3600LL;
+static const uint32_t FIRST_UTC = 1735689600UL;  // 2025-01-01 00:00 UTC
+static const unsigned START_DAYS = 3650U;  // Random starts in 10 years
+static const unsigned DEFAULT_YEARS = 1U;
+static const unsigned DEFAULT_CONFIGS = 40U;
+static const uint8_t SUNDAY = 0U;
+
+
+/*********/
+/* Types */
+/*********/
+
+// Meal of a configuration
+struct MealCfg_t
+{
+  uint8_t Hour, Minute;
+  uint8_t Dotw;      // Bit per day of the week, Sunday bit 0
+  uint8_t Quantity;
+};
+
+// Configuration to simulate
+struct Config_t
+{
+  uint32_t StartUtc;
+  std::vector<MealCfg_t> Meals;
+};
+
+// Meal served or skipped, or expected to
+struct Fire_t
+{
+  uint32_t Utc;
+  uint8_t Quantity;
+  int64_t Local;     // Expected ones: official time of the meal
+};
+
+// Totals of all the configurations
+struct Totals_t
+{
+  double Days;
+  double SchedNs;
+  unsigned long TaskRuns;
+  unsigned long Expected, Missed, Extra, Late, Wrong;
+};
+
+
+/*************/
+/* Variables */
+/*************/
+
+static std::mt19937 Rng;
+static bool Verbose;
+
+// State of the simulated sketch
+static Scheduler *pSched;
+static Feeds *pFeeds;
+static Clock Rtc(TIMEZONE_DIFF, ENABLE_DST);
+static DateTime Time;             // Official time, as in the model
+static uint32_t RtcSetUtc;        // RTC time when set
+static uint64_t RtcSetUs;         // Virtual time when set
+static std::vector<Fire_t> Fires;
+static unsigned long TaskRuns;
+static uint64_t TimeDueUs, FeedDueUs;  // Virtual time of the next task runs
+
+
+/************************/
+/* Oracle: EU DST rules */
+/************************/
+
+/*
+ *   Returns the days from 1970-01-01 to a civil date.
+ */
+static int64_t daysFromCivil(int64_t Year, unsigned Month, unsigned Day)
+{
+  Year -= Month <= 2U;
+  int64_t Era = (Year >= 0? Year: Year - 399) / 400;
+  unsigned Yoe = (unsigned) (Year - Era * 400);
+  unsigned Doy = (153U * (Month + (Month > 2U? -3: 9)) + 2U) / 5U + Day - 1U;
+  unsigned Doe = Yoe * 365U + Yoe / 4U - Yoe / 100U + Doy;
+
+  return Era * 146097 + (int64_t) Doe - 719468;
+}
+
+
+/*
+ *   Returns the civil date of a number of days from 1970-01-01.
+ */
+static void civilFromDays(int64_t Days, int64_t *pYear, unsigned *pMonth,
+  unsigned *pDay)
+{
+  Days += 719468;
+  int64_t Era = (Days >= 0? Days: Days - 146096) / 146097;
+  unsigned Doe = (unsigned) (Days - Era * 146097);
+  unsigned Yoe = (Doe - Doe / 1460U + Doe / 36524U - Doe / 146096U) / 365U;
+  unsigned Doy = Doe - (365U * Yoe + Yoe / 4U - Yoe / 100U);
+  unsigned Mp = (5U * Doy + 2U) / 153U;
+
+  *pDay = Doy - (153U * Mp + 2U) / 5U + 1U;
+  *pMonth = Mp < 10U? Mp + 3U: Mp - 9U;
+  *pYear = (int64_t) Yoe + Era * 400 + (*pMonth <= 2U);
+}
+
+
+/*
+ *   Returns the day of the week of a number of days from 1970-01-01, a
+ *  Thursday, Sunday being 0.
+ */
+static unsigned weekday(int64_t Days)
+{
+  return (unsigned) ((Days % 7 + 11) % 7);
+}
+
+
+/*
+ *   Returns the UTC time, in seconds from 1970, when DST starts or ends in
+ *  a year: 01:00 UTC of the last Sunday of a month of 31 days.
+ */
+static int64_t lastSunday0100(int64_t Year, unsigned Month)
+{
+  int64_t Last = daysFromCivil(Year, Month, 31U);
+
+  return (Last - weekday(Last)) * SECONDS_PER_DAY + SECONDS_PER_HOUR;
+}
+
+
+/*
+ *   Returns the official time for a UTC time, both in seconds from 1970.
+ */
+static int64_t official(int64_t Utc)
+{
+  int64_t Year;
+  unsigned Month, Day;
+  bool Dst;
+
+  civilFromDays(Utc / SECONDS_PER_DAY, &Year, &Month, &Day);
+  Dst = ENABLE_DST && Utc >= lastSunday0100(Year, 3U) &&
+    Utc < lastSunday0100(Year, 10U);
+
+  return Utc + TIMEZONE_DIFF * 60LL + (Dst? SECONDS_PER_HOUR: 0);
+}
+
+
+/*
+ *   Returns when a meal must be served: the first UTC minute whose official
+ *  time has reached the meal time. In the hour skipped when DST starts, the
+ *  end of the hour. In the hour repeated when it ends, the first time.
+ *  Parameters:
+ *  * Local: official time of the meal, in seconds from 1970.
+ */
+static int64_t mealUtc(int64_t Local)
+{
+  int64_t Utc = Local - TIMEZONE_DIFF * 60LL - 2 * SECONDS_PER_HOUR;
+
+  while (official(Utc) < Local)
+    Utc += 60;
+
+  return Utc;
+}
+
+
+/*
+ *   Returns the meals a configuration must serve between two UTC times, in
+ *  order.
+ *  Parameters:
+ *  * Cfg: configuration.
+ *  * FromUtc: boot time: meals of its same minute are not served.
+ *  * ToUtc: end of the simulation.
+ */
+static std::vector<Fire_t> expectedFires(const Config_t &Cfg, int64_t FromUtc,
+  int64_t ToUtc)
+{
+  std::vector<Fire_t> Expected;
+  int64_t FromMinute = FromUtc - FromUtc % 60;
+
+  for (int64_t Days = official(FromUtc) / SECONDS_PER_DAY;
+      Days <= official(ToUtc) / SECONDS_PER_DAY; Days++)
+    for (size_t Idx = 0U; Idx < Cfg.Meals.size(); Idx++)
+    {
+      const MealCfg_t &M = Cfg.Meals[Idx];
+      int64_t Local, Utc;
+
+      if (!(M.Dotw & 1U << weekday(Days)))
+        continue;
+      Local = Days * SECONDS_PER_DAY + M.Hour * SECONDS_PER_HOUR +
+        M.Minute * 60;
+      Utc = mealUtc(Local);
+      if (Utc > FromMinute && Utc <= ToUtc)
+        Expected.push_back({ (uint32_t) Utc, M.Quantity, Local });
+    }
+
+  // Meals due at the same time, after the skipped hour, in meal time order
+  std::sort(Expected.begin(), Expected.end(),
+    [](const Fire_t &Left, const Fire_t &Right)
+    {
+      return Left.Utc < Right.Utc ||
+        (Left.Utc == Right.Utc && Left.Local < Right.Local);
+    });
+
+  return Expected;
+}
+
+
+/*****************/
+/* Sketch tasks */
+/*****************/
+
+/*
+ *   Returns the current UTC time, without reading the RTC.
+ */
+static uint32_t utcNow()
+{
+  return RtcSetUtc + (uint32_t) ((hostMicros() - RtcSetUs) / US_PER_S);
+}
+
+
+/*
+ *   Task: reads the time at the start of every minute, as updateTime().
+ */
+static void taskTime()
+{
+  Time = Rtc.utcToOfficial(Rtc.getUtc());
+  pSched->runIn(TkTime, (60UL - Time.second()) * 1000UL);
+  TimeDueUs = hostMicros() + (60ULL - Time.second()) * US_PER_S;
+  TaskRuns++;
+}
+
+
+/*
+ *   Task: checks for meal time, as the sketch, recording the meals served
+ *  or skipped.
+ */
+static void taskFeed()
+{
+  int8_t Quantity;
+
+  // Before saving the skip state, as EEPROM writes take virtual time
+  FeedDueUs = hostMicros() + FEED_CHECK_INTERVAL * 1000ULL;
+  Quantity = pFeeds->check(Time);
+  if (Quantity)
+    Fires.push_back({ utcNow(), (uint8_t) Quantity, 0 });
+  TaskRuns++;
+}
+
+
+/******************/
+/* Configurations */
+/******************/
+
+/*
+ *   Returns a random configuration: up to all the meals, at distinct times,
+ *  half of them in the hours around the DST changes.
+ */
+static Config_t randomConfig()
+{
+  Config_t Cfg;
+  uint8_t NumMeals = 1U + Rng() % NUM_MEALS;
+
+  Cfg.StartUtc = FIRST_UTC + (Rng() % START_DAYS) * SECONDS_PER_DAY +
+    Rng() % SECONDS_PER_DAY;
+  while (Cfg.Meals.size() < NumMeals)
+  {
+    MealCfg_t M;
+    bool Repeated = false;
+
+    M.Hour = Rng() % 2U? 1U + Rng() % 3U: Rng() % 24U;
+    M.Minute = Rng() % 4U? Rng() % 60U: 15U * (Rng() % 4U);
+    M.Dotw = Rng() % 3U? 1U + Rng() % 127U: _BV(SUNDAY);
+    M.Quantity = 1U + Rng() % Meal::MAX_QUANTITY;
+    for (size_t Idx = 0U; Idx < Cfg.Meals.size(); Idx++)
+      Repeated |= Cfg.Meals[Idx].Hour == M.Hour &&
+        Cfg.Meals[Idx].Minute == M.Minute;
+    if (!Repeated)
+      Cfg.Meals.push_back(M);
+  }
+
+  return Cfg;
+}
+
+
+/*
+ *   Returns the fixed configurations: several meals in the hour skipped and
+ *  repeated by DST, and at its edges, every day and only on Sundays.
+ */
+static std::vector<Config_t> fixedConfigs()
+{
+  static const uint32_t START_2026 = 1767225600UL;  // 2026-01-01 00:00 UTC
+  static const uint8_t EVERY_DAY = 0x7FU;
+  std::vector<Config_t> Cfgs(3U);
+
+  Cfgs[0].StartUtc = START_2026 + 30U;
+  Cfgs[0].Meals = { { 2U, 15U, _BV(SUNDAY), 1U }, { 2U, 45U, _BV(SUNDAY), 2U },
+    { 3U, 0U, _BV(SUNDAY), 3U }, { 8U, 0U, EVERY_DAY, 4U } };
+  Cfgs[1].StartUtc = START_2026 + 7U;
+  Cfgs[1].Meals = { { 1U, 59U, EVERY_DAY, 1U }, { 2U, 0U, EVERY_DAY, 2U },
+    { 2U, 30U, EVERY_DAY, 3U }, { 2U, 59U, EVERY_DAY, 4U },
+    { 3U, 1U, EVERY_DAY, 5U } };
+  Cfgs[2].StartUtc = START_2026 + 59U;
+  Cfgs[2].Meals = { { 0U, 0U, EVERY_DAY, 1U }, { 23U, 59U, EVERY_DAY, 2U },
+    { 2U, 10U, _BV(SUNDAY) | _BV(1U), 3U } };
+
+  return Cfgs;
+}
+
+
+/*
+ *   Simulates a configuration from a fresh EEPROM: sets the RTC, boots the
+ *  Feeds, programs the meals as from the config pages and runs the tasks.
+ *  Then compares the meals served with the expected ones.
+ */
+static void simulate(const Config_t &Cfg, unsigned Years, Totals_t &Tot)
+{
+  typedef std::chrono::steady_clock HostClock;
+  Scheduler Sched;
+  Feeds Feed;
+  uint64_t EndUs;
+  uint32_t EndUtc;
+  std::vector<Fire_t> Expected;
+  double Ns = 0.0;
+  size_t Fire = 0U;
+
+  pSched = &Sched;
+  pFeeds = &Feed;
+  Fires.clear();
+  TaskRuns = 0UL;
+
+  // Boot: the RTC at a random phase from virtual time
+  hostEepromErase();
+  hostAdvance(1U + Rng() % US_PER_S);
+  RtcSetUtc = Cfg.StartUtc;
+  RtcSetUs = hostMicros();
+  hostRtcSet(RtcSetUtc);
+  hostAdvance(US_PER_S - hostMicros() % US_PER_S);  // Tasks at whole seconds
+  Sched.add(TkTime, taskTime, TIME_BUDGET_US);
+  Sched.add(TkFeed, taskFeed, FEED_BUDGET_US);
+  taskTime();
+  Feed.init(Time);
+
+  // Meals, as set in the config pages
+  for (size_t Idx = 0U; Idx < Cfg.Meals.size(); Idx++)
+  {
+    const MealCfg_t &M = Cfg.Meals[Idx];
+    Meal *pMeal = Feed.getMeal(Idx);
+    bool Dotw[DotwUtil::DAYS_IN_A_WEEK];
+
+    for (uint8_t Day = 0U; Day < DotwUtil::DAYS_IN_A_WEEK; Day++)
+      Dotw[Day] = M.Dotw & 1U << Day;
+    pMeal->setTime(M.Hour, M.Minute);
+    pMeal->setDotw(Dotw);
+    pMeal->setQuantity(M.Quantity);
+  }
+  Feed.reset(Time);
+  Sched.runEvery(TkFeed, FEED_CHECK_INTERVAL);
+  FeedDueUs = hostMicros();
+
+  // Run
+  EndUs = hostMicros() + Years * 365ULL * SECONDS_PER_DAY * US_PER_S;
+  while (hostMicros() < EndUs)
+  {
+    HostClock::time_point Start;
+
+    hostAdvanceTo(std::min(TimeDueUs, FeedDueUs));
+    Start = HostClock::now();
+    while (Sched.run())
+      ;
+    Ns += std::chrono::duration<double, std::nano>(HostClock::now() -
+      Start).count();
+  }
+  EndUtc = utcNow();
+
+  // Match the meals served in order with the expected ones
+  Expected = expectedFires(Cfg, Cfg.StartUtc, EndUtc - 60U);
+  for (size_t Idx = 0U; Idx < Expected.size(); Idx++)
+  {
+    const Fire_t &E = Expected[Idx];
+
+    // Before it: served when not expected
+    for (; Fire < Fires.size() && Fires[Fire].Utc < E.Utc; Fire++)
+    {
+      Tot.Extra++;
+      if (Verbose)
+        printf("  extra meal at %u\n", Fires[Fire].Utc);
+    }
+
+    // Not served within its minute: late if it was before the next one
+    if (Fire == Fires.size() || (Fires[Fire].Utc >= E.Utc + 60U &&
+        Idx + 1U < Expected.size() &&
+        Fires[Fire].Utc >= Expected[Idx + 1U].Utc))
+    {
+      Tot.Missed++;
+      if (Verbose)
+        printf("  missed meal at %u\n", E.Utc);
+      continue;
+    }
+    if (Fires[Fire].Utc >= E.Utc + 60U)
+    {
+      Tot.Late++;
+      if (Verbose)
+        printf("  meal at %u served at %u\n", E.Utc, Fires[Fire].Utc);
+    }
+
+    if (Fires[Fire].Quantity != E.Quantity)
+    {
+      Tot.Wrong++;
+      if (Verbose)
+        printf("  meal at %u: quantity %u, expected %u\n", E.Utc,
+          Fires[Fire].Quantity, E.Quantity);
+    }
+    Fire++;
+  }
+  for (; Fire < Fires.size() && Fires[Fire].Utc < EndUtc - 60U; Fire++)
+  {
+    Tot.Extra++;
+    if (Verbose)
+      printf("  extra meal at %u\n", Fires[Fire].Utc);
+  }
+
+  Tot.Expected += Expected.size();
+  Tot.Days += Years * 365.0;
+  Tot.SchedNs += Ns;
+  Tot.TaskRuns += TaskRuns;
+}
+
+
+int main(int argc, char *argv[])
+{
+  std::vector<Config_t> Cfgs;
+  Totals_t Tot = Totals_t();
+  unsigned Years = DEFAULT_YEARS, Configs = DEFAULT_CONFIGS;
+  unsigned long Seed = 1UL;
+  bool Pass;
+
+  for (int Arg = 1; Arg < argc; Arg++)
+  {
+    const char *pValue = Arg + 1 < argc? argv[Arg + 1]: nullptr;
+
+    if (!strcmp(argv[Arg], "--verbose"))
+      Verbose = true;
+    else if (pValue && !strcmp(argv[Arg], "--years"))
+      Years = strtoul(argv[++Arg], nullptr, 10);
+    else if (pValue && !strcmp(argv[Arg], "--configs"))
+      Configs = strtoul(argv[++Arg], nullptr, 10);
+    else if (pValue && !strcmp(argv[Arg], "--seed"))
+      Seed = strtoul(argv[++Arg], nullptr, 10);
+    else
+    {
+      fprintf(stderr, "Usage: %s [--years N] [--configs N] [--seed N] "
+        "[--verbose]\n", argv[0]);
+      return 2;
+    }
+  }
+  Rng.seed(Seed);
+
+  Cfgs = fixedConfigs();
+  while (Cfgs.size() < Configs)
+    Cfgs.push_back(randomConfig());
+
+  for (size_t Idx = 0U; Idx < Cfgs.size(); Idx++)
+  {
+    unsigned long Missed = Tot.Missed + Tot.Extra + Tot.Late + Tot.Wrong;
+
+    simulate(Cfgs[Idx], Years, Tot);
+    if (Verbose || Tot.Missed + Tot.Extra + Tot.Late + Tot.Wrong != Missed)
+      printf("config %u: %u meals from %u\n", (unsigned) Idx,
+        (unsigned) Cfgs[Idx].Meals.size(), Cfgs[Idx].StartUtc);
+  }
+
+  Pass = !Tot.Missed && !Tot.Extra && !Tot.Late && !Tot.Wrong;
+  printf("%u configs, %.0f days: %lu meals expected, %lu missed, "
+    "%lu extra, %lu late, %lu wrong quantity\n", (unsigned) Cfgs.size(),
+    Tot.Days, Tot.Expected, Tot.Missed, Tot.Extra, Tot.Late, Tot.Wrong);
+  printf("scheduler: %.0f host ns per simulated day, %.0f task runs per "
+    "day\n", Tot.SchedNs / Tot.Days, Tot.TaskRuns / Tot.Days);
+  printf("RTC reads: %lu, %.0f per day\n", hostRtcReads(),
+    hostRtcReads() / Tot.Days);
+  printf("%s\n", Pass? "ok": "FAIL");
+
+  return Pass? 0: 1;
+}
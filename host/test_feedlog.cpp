@@ -0,0 +1,235 @@
+/*
+ *   Tests of the feed history log in EEPROM: random appends read back from
+ *  the newest to the oldest against a reference list, through several
+ *  wraps, clock changes and power cycles (the log read again from EEPROM),
+ *  and an append interrupted before its index is written.
+ *  Usage: test_feedlog [--seed N]
+ *  Exits with 1 when a check fails.
+ */
+
+#include "config.h"
+#include <stdio.h>
+#include <random>
+#include <vector>
+#include <EEPROM.h>
+#include "feedlog.h"
+#include "hostsim.h"
+
+
+/*************/
+/* Constants */
+/*************/
+
+static const uint16_t DATA_SIZE = 704U;  // Entries area of the log
+static const int INDEX_ADDR = 256;       // Index ring of the log
+static const uint16_t INDEX_SIZE = 64U;
+static const unsigned ROUNDS = 4U;
+static const unsigned APPENDS_PER_ROUND = 150U;
+static const uint32_t START_UTC = 1735689600UL;  // 2025-01-01 00:00 UTC
+
+
+/*********/
+/* Types */
+/*********/
+
+// Reference of an entry appended
+struct Ref_t
+{
+  uint32_t TimeUtc;  // Whole minutes
+  FeedLog::Type_t Type;
+  uint8_t Quantity;
+  uint8_t Size;      // Bytes it takes in the log
+};
+
+
+/*************/
+/* Variables */
+/*************/
+
+static std::mt19937 Rng;
+static unsigned Failures;
+
+
+/*************/
+/* Functions */
+/*************/
+
+/*
+ *   Reports a failed check.
+ */
+static void check(bool Ok, const char *pWhat, unsigned Index)
+{
+  if (!Ok)
+  {
+    printf("FAIL: %s (entry %u)\n", pWhat, Index);
+    Failures++;
+  }
+}
+
+
+/*
+ *   Returns the bytes an entry takes in the log, as documented: the delta
+ *  from the previous one in 1 to 3 bytes, or the absolute time of the
+ *  previous one in 4 when the clock went back, plus the type byte.
+ */
+static uint8_t entrySize(const std::vector<Ref_t> &Refs, uint32_t TimeUtc)
+{
+  uint32_t Min, LastMin, Delta;
+
+  if (Refs.empty())
+    return 2U;
+
+  Min = TimeUtc / 60UL;
+  LastMin = Refs.back().TimeUtc / 60UL;
+  if (Min < LastMin)
+    return 5U;
+  Delta = Min - LastMin;
+
+  return Delta < 0x100UL? 2U: Delta < 0x10000UL? 3U: Delta < 0x1000000UL?
+    4U: 5U;
+}
+
+
+/*
+ *   Appends an entry to the log and the reference.
+ */
+static void append(FeedLog &Log, std::vector<Ref_t> &Refs, uint32_t TimeUtc)
+{
+  FeedLog::Type_t Type = (FeedLog::Type_t) (Rng() % 3U);
+  uint8_t Quantity = Type == FeedLog::TyServed? 1U + Rng() % 15U: 0U;
+  Ref_t Ref = { (uint32_t) (TimeUtc / 60UL * 60UL), Type, Quantity,
+    entrySize(Refs, TimeUtc) };
+
+  Log.append(Type, Quantity, TimeUtc);
+  Refs.push_back(Ref);
+}
+
+
+/*
+ *   Reads the whole log from EEPROM, as after a power cycle, and checks it
+ *  from the newest entry: all the entries that fit in the log, but the
+ *  oldest one when it was partially overwritten.
+ */
+static void checkLog(const std::vector<Ref_t> &Refs, const char *pWhen)
+{
+  FeedLog Log;
+  FeedLog::Iterator It;
+  FeedLog::Entry_t Entry;
+  unsigned Expected = 0U, Read = 0U;
+  uint16_t Bytes = 0U;
+
+  // Newest entries whose bytes are all in the log
+  while (Expected < Refs.size() &&
+      Bytes + Refs[Refs.size() - 1U - Expected].Size <= DATA_SIZE)
+    Bytes += Refs[Refs.size() - 1U - Expected++].Size;
+
+  Log.init();
+  It = Log.newest();
+  while (It.next(&Entry))
+  {
+    if (Read >= Expected)
+    {
+      check(false, "more entries than appended", Read);
+      break;
+    }
+
+    const Ref_t &Ref = Refs[Refs.size() - 1U - Read];
+
+    check(Entry.TimeUtc == Ref.TimeUtc, "time", Read);
+    check(Entry.Type == Ref.Type, "type", Read);
+    check(Entry.Quantity == Ref.Quantity, "quantity", Read);
+    Read++;
+  }
+  check(Read == Expected, "entries missing", Read);
+  printf("%s: %u entries read, %u appended\n", pWhen, Read,
+    (unsigned) Refs.size());
+}
+
+
+/*
+ *   Checks that an append interrupted before writing the index is not in
+ *  the log, restoring the index area as it was. The log must not be full,
+ *  otherwise the entry overwrites the oldest ones.
+ */
+static void checkInterrupted(const std::vector<Ref_t> &Refs, uint32_t TimeUtc)
+{
+  uint8_t Index[INDEX_SIZE];
+  FeedLog Log;
+  std::vector<Ref_t> Lost(Refs);
+
+  for (uint16_t Idx = 0U; Idx < INDEX_SIZE; Idx++)
+    Index[Idx] = EEPROM.read(INDEX_ADDR + Idx);
+  Log.init();
+  append(Log, Lost, TimeUtc);
+  for (uint16_t Idx = 0U; Idx < INDEX_SIZE; Idx++)
+    EEPROM.write(INDEX_ADDR + Idx, Index[Idx]);
+
+  checkLog(Refs, "interrupted");
+}
+
+
+/*
+ *   Returns the time of the next random entry: mostly meals hours apart,
+ *  some manual feeds within minutes, some long absences and the clock
+ *  set back now and then.
+ */
+static uint32_t nextTime(uint32_t TimeUtc)
+{
+  unsigned Kind = Rng() % 20U;
+
+  if (Kind < 10U)
+    return TimeUtc + 60UL * (1UL + Rng() % 255UL);
+  if (Kind < 17U)
+    return TimeUtc + 60UL * (256UL + Rng() % 20000UL);
+  if (Kind < 18U)
+    return TimeUtc + 60UL * (0x10000UL + Rng() % 0x100000UL);
+  if (Kind < 19U)
+    return TimeUtc + Rng() % 60UL;  // Same minute
+  return TimeUtc - 60UL * (1UL + Rng() % 600UL);
+}
+
+
+int main(int argc, char *argv[])
+{
+  std::vector<Ref_t> Refs;
+  uint32_t TimeUtc = START_UTC;
+  unsigned long Seed = 1UL;
+
+  if (argc == 3 && !strcmp(argv[1], "--seed"))
+    Seed = strtoul(argv[2], nullptr, 10);
+  else if (argc != 1)
+  {
+    fprintf(stderr, "Usage: %s [--seed N]\n", argv[0]);
+    return 2;
+  }
+  Rng.seed(Seed);
+
+  // Never used: empty
+  hostEepromErase();
+  checkLog(Refs, "erased");
+
+  // Random appends, the log read again from EEPROM after each round
+  for (unsigned Round = 0U; Round < ROUNDS; Round++)
+  {
+    FeedLog Log;
+    char When[16];
+
+    Log.init();
+    for (unsigned Idx = 0U; Idx < APPENDS_PER_ROUND; Idx++)
+    {
+      TimeUtc = nextTime(TimeUtc);
+      append(Log, Refs, TimeUtc);
+    }
+    snprintf(When, sizeof When, "round %u", Round);
+    checkLog(Refs, When);
+
+    // Before the log is full: power lost between an entry and its index
+    if (!Round)
+      checkInterrupted(Refs, nextTime(TimeUtc));
+  }
+
+  if (Failures)
+    printf("%u checks failed\n", Failures);
+
+  return Failures? 1: 0;
+}
@@ -0,0 +1,94 @@
+/*
+ *   Tests of the display number formatter: FmtUtil::uint() against
+ *  snprintf() for widths 1 to 5, including numbers that do not fit, and the
+ *  time and date fields.
+ *  Usage: test_fmtutil
+ *  Exits with 1 when a check fails.
+ */
+
+#include "config.h"
+#include <stdio.h>
+#include <string.h>
+#include "fmtutil.h"
+
+
+/*************/
+/* Constants */
+/*************/
+
+static const uint8_t MAX_WIDTH = 5U;
+static const char GUARD = '#';  // Fills the buffer past the field
+
+
+/*************/
+/* Variables */
+/*************/
+
+static unsigned Failures;
+
+
+/*************/
+/* Functions */
+/*************/
+
+/*
+ *   Reports a failed check.
+ */
+static void check(bool Ok, const char *pWhat, const char *pGot,
+  const char *pExpected)
+{
+  if (!Ok)
+  {
+    printf("FAIL: %s: \"%s\", expected \"%s\"\n", pWhat, pGot, pExpected);
+    Failures++;
+  }
+}
+
+
+/*
+ *   Checks uint() for a number and width: the least significant Width
+ *  digits, zero padded, the terminator and its returned pointer right after
+ *  them and nothing written past it.
+ */
+static void checkUint(uint16_t Value, uint8_t Width)
+{
+  char szGot[MAX_WIDTH + 3U], szExpected[8], szWhat[24];
+  unsigned long Modulo = 1UL;
+  char *pEnd;
+
+  for (uint8_t Digit = 0U; Digit < Width; Digit++)
+    Modulo *= 10UL;
+  snprintf(szExpected, sizeof szExpected, "%0*lu", Width, Value % Modulo);
+  snprintf(szWhat, sizeof szWhat, "uint(%u, %u)", Value, Width);
+
+  memset(szGot, GUARD, sizeof szGot);
+  pEnd = FmtUtil::uint(szGot, Value, Width);
+  check(!strcmp(szGot, szExpected), szWhat, szGot, szExpected);
+  check(pEnd == szGot + Width, szWhat, "returned pointer", "terminator");
+  check(szGot[Width + 1U] == GUARD, szWhat, "written past the terminator",
+    "untouched");
+}
+
+
+int main()
+{
+  static const uint16_t VALUES[] = { 0U, 1U, 7U, 9U, 10U, 42U, 99U, 100U,
+    305U, 999U, 1000U, 2026U, 9999U, 10000U, 12345U, 65535U };
+  char szGot[16];
+
+  for (uint8_t Width = 1U; Width <= MAX_WIDTH; Width++)
+    for (size_t Idx = 0U; Idx < sizeof VALUES / sizeof *VALUES; Idx++)
+      checkUint(VALUES[Idx], Width);
+  for (uint32_t Value = 0UL; Value <= UINT16_MAX; Value++)
+    checkUint((uint16_t) Value, MAX_WIDTH);
+
+  FmtUtil::time(szGot, 7U, 5U);
+  check(!strcmp(szGot, "07:05"), "time", szGot, "07:05");
+  FmtUtil::date(szGot, 29U, 3U, 26U);
+  check(!strcmp(szGot, "29/03/26"), "date", szGot, "29/03/26");
+
+  if (Failures)
+    printf("%u checks failed\n", Failures);
+
+  return Failures? 1: 0;
+}
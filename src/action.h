@@ -3,14 +3,12 @@
 
 #include "config.h"
 #include <Arduino.h>
-#include <RTClib.h>
-#include "meal.h"
 
 
 /*
  *   This header defines class Action, which is used to communicate from the
- *  Display to the outside required actions such us changes in configuration,
- *  manual feed or to request further data.
+ *  Display to the outside required actions such us changes in configuration
+ *  or manual feed.
  */
 class Action
 {
@@ -23,70 +21,21 @@ public:
   enum ActionId: uint8_t
   {
     AcNone=0,
-    AcNeedTime,
-    AcNeedNextMeal,
-    AcNeedTimeUtc,
-    AcNeedMeal,
     AcSetTimeUtc,
     AcSetMeal,
     AcManualFeedStart,
     AcManualFeedContinue,
     AcManualFeedEnd,
     AcSkipMeal,
-    AcReset
+    AcReset,
+    AcConfigEnd      // Back in the main page, configuration is over
   };
 
-  // Constructors
-  Action(): Id(AcNone) {}
+  // Constructors. Trivially copyable: copied with no code per action type.
+  // Value initialization, like Action(), sets AcNone
+  Action() = default;
   Action(ActionId AcId): Id(AcId) {}
 
-  // Copy constructor
-  Action(const Action &Ac):
-    Id(Ac.Id)
-  {
-#pragma GCC diagnostic push
-// Disable: warning: enumeration value not handled in switch
-#pragma GCC diagnostic ignored "-Wswitch"
-
-    switch (Id)
-    {
-    case AcNeedMeal:
-    case AcSetMeal:
-      MealId = Ac.MealId;
-      break;
-    case AcSetTimeUtc:
-      Time = Ac.Time;
-      break;
-    }
-
-#pragma GCC diagnostic pop
-  }
-
-  // Assignment operator
-  Action & Action::operator=(const Action &Ac)
-  {
-    Id = Ac.Id;
-
-#pragma GCC diagnostic push
-// Disable: warning: enumeration value not handled in switch
-#pragma GCC diagnostic ignored "-Wswitch"
-
-    switch (Id)
-    {
-    case AcNeedMeal:
-    case AcSetMeal:
-      MealId = Ac.MealId;
-      break;
-    case AcSetTimeUtc:
-      Time = Ac.Time;
-      break;
-    }
-
-#pragma GCC diagnostic pop
-
-    return *this;
-  }
-
 
   /***************/
   /* Member data */
@@ -95,10 +44,12 @@ public:
   ActionId Id;
   union
   {
-    uint8_t MealId;  // Used by AcNeedMeal, AcSetMeal
-    DateTime Time;   // Used by AcSetTime
+    uint8_t MealId;   // Used by AcSetMeal
+    uint32_t TimeUtc; // Used by AcSetTimeUtc: DateTime::unixtime() format
   };
 };
 
+static_assert(__is_pod(Action), "Action must be plain old data");
+
 
 #endif  // _ACTION_H_
\ No newline at end of file
@@ -1,8 +1,49 @@
 #include "config.h"
 #include <assert.h>
 #include "auger.h"
+#include "timer1.h"
 
 
+/****************/
+/* Friend stuff */
+/****************/
+
+/*
+ *   Timer callback moving the motor when a half step is due, called from the
+ *  timer ISR every tick. Defined out of the class to match the
+ *  void (*)(void *) type. It will behave as belonging to object pObj.
+ */
+void _isrAugerTick(void *pObj)
+{
+  ((Auger *) pObj)->_tick();
+}
+
+
+/********************/
+/* Module functions */
+/********************/
+
+/*
+ *   Calculates the greatest common divisor of two numbers.
+ */
+static uint32_t _gcd(uint32_t A, uint32_t B)
+{
+  while (B)
+  {
+    uint32_t Rem = A % B;
+
+    A = B;
+    B = Rem;
+  }
+
+  return A;
+}
+
+
+/***************/
+/* Class stuff */
+/***************/
+
 /*
  *   Constructor. Initializes class and stepper motor EasyDriver controller.
  *  Parameters:
@@ -11,7 +52,8 @@
  *  * PinMs1: MS1 pin in controller, determining step size with MS2.
  *  * PinMs2: MS2 pin in controller, determining step size with MS1.
  *  * PinEnable: ENABLE pin in controller, activating enery to the motor.
- *  * Rpm: movement speed in revolutions per second. MAX=120.
+ *  * Rpm: movement speed in revolutions per minute. MAX=120. Speeds over a
+ *    half step per Timer1 tick (18.75 rpm micro-stepping) are limited to it.
  *  * EighthRevsPerQtyUnit: Eighth revolutions per quantity unit. One full
  *    revolution is 8 eighths. Note that Quantity*EighthRevsPerQtyUnit<256
  *    or an overflow condition will happen.
@@ -24,16 +66,30 @@ Auger::Auger(uint8_t PinStep, uint8_t PinDir, uint8_t PinMs1, uint8_t PinMs2,
   _PinMs1(PinMs1),
   _PinMs2(PinMs2),
   _PinEnable(PinEnable),
-  _EighthRevsPerQtyUnit(EighthRevsPerQtyUnit),
   _StepsContinuousFeed(EighthRevsPerQtyUnit * _STEPS_PER_8REV),
   _StepsBackup(EighthRevsPerBackup * _STEPS_PER_8REV),
-  // Calculate ms per half step
-  _HalfStepTime( (unsigned int)
-    ((60UL * 1000000UL) /
-    (uint32_t(Rpm) * uint32_t(_STEPS_PER_REV * 2U))))
+  _Phase(PhIdle),
+  _StepsLeft(0U),
+  _UnitsLeft(0U),
+  _Continuous(false),
+  _StepHigh(false),
+  _TickAcc(0U)
 {
+  uint32_t HalfStepsPerMin = uint32_t(Rpm) * _STEPS_PER_REV * 2U;
+  uint32_t TicksPerMin = 60UL * 1000UL;
+  uint32_t Gcd;
+
   // Avoid burning the motor!
-  assert(Rpm <= 120U);
+  assert(Rpm > 0U && Rpm <= 120U);
+  // Phases are never empty
+  assert(EighthRevsPerQtyUnit > 0U && EighthRevsPerBackup > 0U);
+
+  // Speed as a fraction of half steps per tick, at most 1
+  if (HalfStepsPerMin > TicksPerMin)
+    HalfStepsPerMin = TicksPerMin;
+  Gcd = _gcd(HalfStepsPerMin, TicksPerMin);
+  _HalfSteps = HalfStepsPerMin / Gcd;
+  _Ticks = TicksPerMin / Gcd;
 
   // Prepare Arduino to control EasyDriver
   pinMode(PinStep, OUTPUT);
@@ -52,107 +108,176 @@ Auger::Auger(uint8_t PinStep, uint8_t PinDir, uint8_t PinMs1, uint8_t PinMs2,
 
 
 /*
- *   Synchronously moves the auger to feed.
+ *   Starts feeding a meal, or adds it to the one being fed. The motor moves
+ *  in the timer interrupt.
  *  Paramters:
- *  * Quantity: size of the meal. Note that Quantity*Hrqu<256
- *    or an overflow condition will happen.
+ *  * Quantity: size of the meal.
  */
-void Auger::feed(uint8_t Quantity) const
+void Auger::feed(uint8_t Quantity)
 {
-  uint16_t Steps;
-  
-  // Calculate number of steps for this meal
-  Steps = uint16_t(_EighthRevsPerQtyUnit) * _STEPS_PER_8REV;
-  //  Steps = uint16_t(Quantity * _EighthRevsPerQtyUnit) * _STEPS_PER_8REV;
+  if (!Quantity)
+    return;
 
-
-  // Engage the motor
-  _enableMotor();
-
-  // Deliver the food turning the motor and jiggling every quantity unit
-  while (Quantity--)
+  // The ISR updates the phase and the units left
+  noInterrupts();
+  if (_Phase == PhIdle)
   {
-    _jiggle();
-    _turnMotor(Steps);
+    _UnitsLeft = Quantity - 1U;
+    _start();
   }
- 
-  // Save power
-  _disableMotor();
+  else
+    _UnitsLeft += Quantity;
+  interrupts();
 }
 
 
 /*
- *   Starts a semi-synchronous feed.
+ *   Starts a manual feed, delivering units until endFeeding(). The motor
+ *  moves in the timer interrupt.
  */
-void Auger::startFeeding() const
+void Auger::startFeeding()
 {
-  _enableMotor();
-  keepFeeding();
+  noInterrupts();
+  _Continuous = true;
+  if (_Phase == PhIdle)
+  {
+    _UnitsLeft = 0U;
+    _start();
+  }
+  interrupts();
 }
 
 
 /*
- *   Continues a semi-synchronous feed, jiggling on each call
+ *   Ends a manual feed. The motor stops at once, unless a meal is pending,
+ *  which is completed.
  */
-void Auger::keepFeeding() const
+void Auger::endFeeding()
 {
-  _jiggle();
-  _turnMotor(_StepsContinuousFeed);
+  noInterrupts();
+  _Continuous = false;
+  if (_Phase != PhIdle && !_UnitsLeft)
+    _stop();
+  interrupts();
 }
 
 
 /*
- *   Ends a semi-synchronous feed. Does not deliver actual food.
+ *   Tells whether the auger is feeding.
+ *  Returns: true while the motor is moving, false when powered down.
  */
-void Auger::endFeeding() const
+bool Auger::busy() const
 {
-  _disableMotor();
+  // Single byte read: atomic
+  return _Phase != PhIdle;
 }
 
 
 /*
- *   Powers up the motor.
+ *   Powers up the motor and starts stepping the first quantity unit. Called
+ *  with interrupts disabled.
  */
-void Auger::_enableMotor() const
+void Auger::_start()
 {
   digitalWrite(_PinEnable, LOW);
+  _startUnit();
+  _TickAcc = 0U;
+  timer1Start(T1Auger, _isrAugerTick, this, 1U, true);
 }
 
 
 /*
- *   Powers down the motor.
+ *   Stops stepping and powers down the motor, leaving STEP low. Called with
+ *  interrupts disabled or from the ISR.
  */
-void Auger::_disableMotor() const
+void Auger::_stop()
 {
+  timer1Stop(T1Auger);
+  digitalWrite(_PinStep, LOW);
+  _StepHigh = false;
+  _Phase = PhIdle;
   digitalWrite(_PinEnable, HIGH);
 }
 
 
 /*
- *   Turns the motor (auger)
- *   Parameters:
- *   * NumSteps: how many steps the motor will be turned
+ *   Accounts for a timer tick, moving half a step when one is due: every
+ *  _Ticks ticks, _HalfSteps half steps, as evenly spread as the ticks allow.
+ *  At 15 rpm it is 4 every 5 ticks. Called from the ISR.
  */
-void Auger::_turnMotor(uint16_t NumSteps) const
+void Auger::_tick()
 {
-  while (--NumSteps)
+  // Compare before adding so it never overflows
+  if (_TickAcc >= _Ticks - _HalfSteps)
   {
-    // Perform one full step
-    digitalWrite(_PinStep, HIGH);
-    delayMicroseconds(_HalfStepTime);
-    digitalWrite(_PinStep, LOW);
-    delayMicroseconds(_HalfStepTime);
+    _TickAcc -= _Ticks - _HalfSteps;
+    _step();
   }
+  else
+    _TickAcc += _HalfSteps;
+}
+
+
+/*
+ *   Moves the motor half a step: a full step is completed on the falling
+ *  edge of STEP, moving to the next phase when the current one is done.
+ *  Called from the ISR.
+ */
+void Auger::_step()
+{
+  _StepHigh = !_StepHigh;
+  digitalWrite(_PinStep, _StepHigh? HIGH: LOW);
+
+  if (!_StepHigh && !--_StepsLeft)
+    _nextPhase();
 }
 
 
 /*
- *  Jiggles the auger back and forth to prevent it getting stuck.
+ *   Starts a quantity unit: jiggles the auger back and forth to prevent it
+ *  getting stuck, then feeds.
  */
-void Auger::_jiggle() const
+void Auger::_startUnit()
 {
   digitalWrite(_PinDir, _DIR_BACKWARD);
-  _turnMotor(_StepsBackup);
-  digitalWrite(_PinDir, _DIR_FORWARD);
-  _turnMotor(_StepsBackup);
+  _Phase = PhBackward;
+  _StepsLeft = _StepsBackup;
+}
+
+
+/*
+ *   Moves to the next phase once the current one is done, powering down the
+ *  motor after the last unit. Called from the ISR.
+ */
+void Auger::_nextPhase()
+{
+#pragma GCC diagnostic push
+// Disable: warning: enumeration value 'PhIdle' not handled in switch
+#pragma GCC diagnostic ignored "-Wswitch"
+
+  switch (_Phase)
+  {
+  case PhBackward:
+    digitalWrite(_PinDir, _DIR_FORWARD);
+    _Phase = PhForward;
+    _StepsLeft = _StepsBackup;
+    break;
+  case PhForward:
+    _Phase = PhFeed;
+    _StepsLeft = _StepsContinuousFeed;
+    break;
+  case PhFeed:
+    if (_UnitsLeft || _Continuous)
+    {
+      if (_UnitsLeft)
+        _UnitsLeft--;
+      _startUnit();
+    }
+    else
+      // Save power
+      _stop();
+    break;
+  }
+
+#pragma GCC diagnostic pop
 }
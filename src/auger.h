@@ -5,9 +5,19 @@
 #include <Arduino.h>
 
 
+// Timer callbacks need to be functions of type void (*)(void *) -> cannot be
+// defined inside class, so make them global friend functions
+void _isrAugerTick(void *pObj);
+
+
 /*
  *   Class to interface with the EasyDriver controller and a stepper motor
  *  attached and connected to the auger that dispenses the food.
+ *   Feeding does not block: feed() and startFeeding() just start it, and
+ *  the motor is stepped from the Timer1 interrupt until busy() returns false.
+ *  The half steps are spread over the 1 ms ticks so that their average rate
+ *  is exactly the configured speed, even if it is not a whole number of
+ *  ticks.
  */
 class Auger
 {
@@ -16,32 +26,49 @@ public:
     uint8_t PinEnable, uint8_t Rpm, uint8_t EighthRevsPerQtyUnit,
     uint8_t EighthRevsPerBackup);
 
-  void feed(uint8_t Quantity) const;
-  void startFeeding() const;
-  void keepFeeding() const;
-  void endFeeding() const;
+  void feed(uint8_t Quantity);
+  void startFeeding();
+  void endFeeding();
+  bool busy() const;
 
 protected:
+  friend void _isrAugerTick(void *pObj);
+
   // static const uint16_t _STEPS_PER_REV = 200U;  // Full steps
   static const uint16_t _STEPS_PER_REV = 1600U; // Micro-stepping x8
   static const uint16_t _STEPS_PER_8REV = _STEPS_PER_REV / 8U;  // 1/8 of a rev
   static const uint8_t _DIR_FORWARD = LOW;
   static const uint8_t _DIR_BACKWARD = HIGH;
 
+  // Phases of a quantity unit: jiggle backward and forward, then feed
+  enum Phase_t: uint8_t
+  {
+    PhIdle = 0U, PhBackward, PhForward, PhFeed
+  };
+
   const uint8_t _PinStep;
   const uint8_t _PinDir;
   const uint8_t _PinMs1;
   const uint8_t _PinMs2;
   const uint8_t _PinEnable;
-  const uint8_t _EighthRevsPerQtyUnit;
   const uint16_t _StepsContinuousFeed;
   const uint16_t _StepsBackup;
-  const unsigned int _HalfStepTime;  // 1/2 of a step in microseconds
+  uint16_t _HalfSteps;         // Speed: _HalfSteps half steps every _Ticks
+  uint16_t _Ticks;             // Timer1 ticks (ms), in lowest terms
+
+  volatile Phase_t _Phase;     // Current phase of the quantity unit (ISR)
+  volatile uint16_t _StepsLeft;  // Steps left in the current phase (ISR)
+  volatile uint8_t _UnitsLeft;   // Quantity units left after the current one
+  volatile bool _Continuous;   // Manual feed: units until endFeeding()
+  volatile bool _StepHigh;     // STEP pin level, HIGH on 1st half of a step
+  volatile uint16_t _TickAcc;  // Ticks owed to half steps, under _Ticks (ISR)
 
-  void _enableMotor() const;
-  void _disableMotor() const;
-  void _turnMotor(uint16_t NumSteps) const;
-  void _jiggle() const;
+  void _start();
+  void _stop();
+  void _tick();
+  void _step();
+  void _startUnit();
+  void _nextPhase();
 };
 
 #endif  // _AUGER_H_
\ No newline at end of file
@@ -1,18 +1,44 @@
 #include "config.h"
 #include <avr/wdt.h>
+#include <avr/sleep.h>
+#include <avr/power.h>
 #include "event.h"
 #include "action.h"
 #include "feeds.h"
+#include "feedlog.h"
 #include "switchpnl.h"
 #include "clock.h"
+#include "uimodel.h"
 #include "display.h"
 #include "auger.h"
+#include "scheduler.h"
+#include "ringbuf.h"
+#include "prof.h"
+#include "memdiag.h"
 
 
 /*************/
 /* Constants */
 /*************/
 
+// Scheduler tasks, in priority order (highest first)
+enum TaskId_t: uint8_t
+{
+  TkEvents = 0U,    // Event dispatch to the display, one per run
+  TkMeals,          // Meal load at boot, after the first screen
+  TkSwitches,       // Switch panel events
+  TkTime,           // Time refresh when the minute changes
+  TkFeed,           // Meal time check
+  TkNextMeal,       // Next meal refresh some time after a meal
+  TkFlush,          // Changed meals saved to EEPROM, one per run
+  TkDisplay,        // Display blinking
+#ifdef ENABLE_DIAG_SERIAL
+  TkDiag,           // SRAM report over serial
+#endif
+  TkNum
+};
+static_assert(TkNum <= SCHED_MAX_TASKS, "Increase SCHED_MAX_TASKS");
+
 // Swtich & encoder constants
 static const uint8_t ENC_NUM_PINS = 2U;  // Number of pins per encoder
 static const uint8_t NUM_BUTTONS = 2U;  // Number of swtiches of type button
@@ -47,21 +73,44 @@ static const uint8_t PIN_ED_STEP = 4;
 // Object to control feeding times
 static Feeds FeedData;
 
+// History of feeds in EEPROM
+static FeedLog History;
+
 // Object to manage the input buttons and rotary encoder
 static SwitchPnl SwitchPanel(PIN_ENC[0], PIN_ENC[1], PIN_BTN_ENT, PIN_BTN_BCK);
 
 // Object to manage time and conversions
 static Clock Rtc(TIMEZONE_DIFF, ENABLE_DST);
 
+// Data shown in the LCD display, kept up to date by the main loop
+static UiModel Model;
+
 // Object to manage the LCD display
-static Display Lcd(PIN_LCD_RS, PIN_LCD_E, PIN_LCD_D4, PIN_LCD_D5, PIN_LCD_D6,
-  PIN_LCD_D7);
+static Display Lcd(&Model, PIN_LCD_RS, PIN_LCD_E, PIN_LCD_D4, PIN_LCD_D5,
+  PIN_LCD_D6, PIN_LCD_D7);
 
 // Object to control the auger on the EasyDriver stepper motor
 static Auger Edsm(PIN_ED_STEP, PIN_ED_DIR, PIN_ED_MS1, PIN_ED_MS2,
   PIN_ED_ENABLE, AUGER_RPM, AUGER_EIGHTH_REVS_PER_MEAL_QTY,
   AUGER_EIGHTH_REVS_BACKUP);
 
+// Cooperative scheduler running all the tasks
+static Scheduler Sched;
+
+// Switch events waiting to be dispatched to the display. It holds all the
+// ones the switch panel can have pending: its button queue and the detents
+static RingBuf<Event, EVENT_QUEUE_SIZE> Events;
+static_assert(EVENT_QUEUE_SIZE > SWITCH_EDGE_QUEUE_SIZE,
+  "EVENT_QUEUE_SIZE too small");
+
+// Model change notifications waiting to be dispatched to the display, a bit
+// per Event::EventId. Repeated ones are merged, as pages read the model
+static uint8_t Notices;
+
+// Whether meals have been edited in the config pages and the user has not
+// left them yet: only then switch use postpones saving them
+static bool Configuring;
+
 
 /***********/
 /* Methods */
@@ -69,11 +118,25 @@ static Auger Edsm(PIN_ED_STEP, PIN_ED_DIR, PIN_ED_MS1, PIN_ED_MS2,
 
 // Local function prototypes
 // Arduino generates incorrectly the ones using the Event class
-static bool sendEventAndHandleActions(Event E);
-static Event eventTime();
-static Event eventNextMeal();
-static bool checkFeedTime();
+static void postEvent(const Event &E);
+static void notify(Event::EventId EvId);
+static void sendEventAndHandleActions(const Event &E);
+static void updateTime();
+static void updateNextMeal();
+static void taskEvents();
+static void taskMeals();
+static void taskSwitches();
+static void taskTime();
+static void taskFeed();
+static void taskNextMeal();
+static void taskFlush();
+static void taskDisplay();
+#ifdef ENABLE_DIAG_SERIAL
+static void taskDiag();
+static void printModuleSizes();
+#endif
 static void initClock();
+static void sleepIdle();
 static void reboot();
 
 
@@ -82,17 +145,54 @@ static void reboot();
  */
 void setup()
 {
+  PROF_BOOT(Prof::BtSetup);
+
+  // Power down unused peripherals: ADC (analog pins are used as digital),
+  // SPI, USART (unless reporting) and Timer2
+  power_adc_disable();
+  power_spi_disable();
+#ifdef ENABLE_DIAG_SERIAL
+  Serial.begin(DIAG_SERIAL_BAUD);
+#else
+  power_usart0_disable();
+#endif
+  power_timer2_disable();
+
+  // Register tasks, not scheduled yet
+  Sched.add(TkEvents, taskEvents, EVENT_BUDGET_US);
+  Sched.add(TkMeals, taskMeals, MEALS_BUDGET_US);
+  Sched.add(TkSwitches, taskSwitches, SWITCH_BUDGET_US);
+  Sched.add(TkTime, taskTime, TIME_BUDGET_US);
+  Sched.add(TkFeed, taskFeed, FEED_BUDGET_US);
+  Sched.add(TkNextMeal, taskNextMeal, NEXTMEAL_BUDGET_US);
+  Sched.add(TkFlush, taskFlush, FLUSH_BUDGET_US);
+  Sched.add(TkDisplay, taskDisplay, DISPLAY_BUDGET_US);
+#ifdef ENABLE_DIAG_SERIAL
+  Sched.add(TkDiag, taskDiag, DIAG_BUDGET_US);
+#endif
+
   // Initialize buttons object
   SwitchPanel.init();
+  PROF_BOOT(Prof::BtSwitches);
 
   // Initialize RTC and check for errors
   initClock();
-
-  // Initialize feed data structure
-  FeedData.init(Rtc.getOfficial());
-
-  // Send event to initialize display
-  sendEventAndHandleActions(Event(Event::EvInit));
+  PROF_BOOT(Prof::BtClock);
+
+  // Read time into the model
+  updateTime();
+  PROF_BOOT(Prof::BtTime);
+
+  // Fast boot: show the time as soon as possible, without next meal. The
+  // meals are loaded by their task once the first screen is drawn
+  Model.pMeals = FeedData.getMeal(0U);
+  Model.NextMeal.Status = Feeds::NEXT_NONE;
+  notify(Event::EvInit);
+  Sched.runIn(TkMeals, 0UL);
+
+  // Schedule periodic tasks. The time task schedules itself, switches and
+  // meal checks wait for the meals
+  Sched.runEvery(TkDisplay, DISPLAY_REFRESH_INTERVAL);
 }
 
 
@@ -101,214 +201,358 @@ void setup()
  */
 void loop()
 {
-  static unsigned long LastCheckFeed = 0UL;
-  static unsigned long LastUpdateTime = 0UL;
-  static unsigned long LastMealTime;
-  static bool UpdateMealTime = false;
-  unsigned long CurTime;
+  PROF_LOOP();
+
+  // Sleep until the next interrupt when no task is due
+  if (!Sched.run())
+    sleepIdle();
+}
 
-  // Get current time
-  CurTime = millis();
 
-  // Check update time (counter overflow works well)
-  if (CurTime - LastUpdateTime >= TIME_UPDATE_INTERVAL)
+/*
+ *   Task: sends an event to the display and handles the action it unchains:
+ *  model notifications first, in EventId order so EvInit draws the first
+ *  screen, then the oldest switch event. One per run to bound its time: it
+ *  reschedules itself while there are more.
+ */
+static void taskEvents()
+{
+  Event E;
+
+  if (Notices)
   {
-    LastUpdateTime = CurTime;
-    sendEventAndHandleActions(eventTime());
+    E.Id = Event::EvInit;
+    while (!(Notices & _BV(E.Id)))
+      E.Id = (Event::EventId) (E.Id + 1U);
+    Notices &= ~_BV(E.Id);
+    sendEventAndHandleActions(E);
   }
+  else if (Events.pop(E))
+    sendEventAndHandleActions(E);
 
-  // Check feed time every FEED_CHECK_INTERVAL ms (counter overflow works well)
-  if (CurTime - LastCheckFeed >= FEED_CHECK_INTERVAL)
+  if (Notices || !Events.empty())
+    Sched.runIn(TkEvents, 0UL);
+}
+
+
+/*
+ *   Task: second part of the boot, run once after the first screen is drawn
+ *  (events have higher priority). Loads the meals from EEPROM, or writes the
+ *  default ones the first time, shows the next meal and starts the tasks
+ *  that need the meals: meal checks and the switches, which can open the
+ *  meal pages.
+ */
+static void taskMeals()
+{
+  PROF_BOOT(Prof::BtScreen);
+
+  FeedData.init(Model.Time);
+  History.init();
+  updateNextMeal();
+  notify(Event::EvNextMeal);
+
+  Sched.runEvery(TkSwitches, SWITCH_CHECK_INTERVAL);
+  Sched.runEvery(TkFeed, FEED_CHECK_INTERVAL);
+  PROF_BOOT(Prof::BtMeals);
+
+#ifdef ENABLE_DIAG_SERIAL
+  // Static sizes and boot times once, the SRAM use now and periodically
+  printModuleSizes();
+#ifdef ENABLE_PROFILING
+  Prof::printBoot(Serial);
+#endif
+  Sched.runEvery(TkDiag, DIAG_SERIAL_INTERVAL);
+#endif
+}
+
+
+/*
+ *   Task: posts the pending switch events. While the display has not taken
+ *  the previous ones, the new ones wait in the switch panel, so none is
+ *  lost. While the user keeps using the switches in the config pages, saving
+ *  changed meals is postponed.
+ */
+static void taskSwitches()
+{
+  Event E(Event::EvSwitch);
+  bool Used = false;
+
+  // There are a few at most: the button presses and releases and the encoder
+  // detents
+  while (!Events.full())
   {
-    LastCheckFeed = CurTime;
-    if (checkFeedTime())
     {
-      LastMealTime = CurTime;
-      UpdateMealTime = true;
+      PROF_SECTION(Prof::SeSwitchCheck);
+      E.Switch = SwitchPanel.check(&E.Steps, &E.DetentMs);
     }
+    if (E.Switch == Event::SwEvNone)
+      break;
+    postEvent(E);
+    Used = true;
   }
 
-  // MEAL_UPDATE_DELAY ms after serving a meal, the LCD next meal is updated
-  if (UpdateMealTime && CurTime - LastMealTime >= MEAL_UPDATE_DELAY)
-  {
-    UpdateMealTime = false;
-    sendEventAndHandleActions(eventNextMeal());
-  }
+  // Once config is over the save is already due, do not push it back
+  if (Used && Configuring && FeedData.isDirty())
+    Sched.runIn(TkFlush, MEAL_FLUSH_IDLE_DELAY);
+}
 
-  // Loop checking switch panel
-  for (uint16_t SwIdx=SWITCH_LOOP_CNT; SwIdx; SwIdx--)
-  {
-    Event::SwitchEvent SwE;
-    bool ManuallyFeeding = false;
 
-    // Loop for manual feeding (synchronous interactive task)
-    do
+/*
+ *   Task: updates the time in the model and display when the displayed minute
+ *  changes. updateTime() schedules the next run.
+ */
+static void taskTime()
+{
+  updateTime();
+  notify(Event::EvTime);
+}
+
+
+/*
+ *   Task: checks whether it is time for a meal, serves it and updates the
+ *  next meal in the FeedData object and LCD.
+ */
+static void taskFeed()
+{
+  int8_t Quantity;
+
+  // Check whether it is meal time, with the official time of the model: it
+  // changes only once a minute, like meal times
+  Quantity = FeedData.check(Model.Time);
+
+  // It is meal time when the quantity is not 0
+  if (Quantity)
+  {
+    // Positive quantity is meal amount, negative when we are skipping the meal
+    if (Quantity > 0)
     {
-      // Did we get a switch event?
-      if ((SwE = SwitchPanel.check(SWITCH_STAB_LOOP_CNT)) != Event::SwEvNone)
-      {
-       // Build event
-        Event E(Event::EvSwitch);
-        E.Switch = SwE;
-
-        // Notify event and handle unchained actions
-        ManuallyFeeding = sendEventAndHandleActions(E);
-      }
-      else if (ManuallyFeeding)
-        // Keep feeding when no switches registered
-        Edsm.keepFeeding();
+      // Deliver meal
+      Edsm.feed(Quantity);
+      History.append(FeedLog::TyServed, Quantity, Model.TimeUtc.unixtime());
     }
-    while (ManuallyFeeding);
+    else
+      History.append(FeedLog::TySkipped, 0U, Model.TimeUtc.unixtime());
+
+    // Update model and LCD
+    updateNextMeal();
+    notify(Event::EvNextMeal);
+
+    // Both when served and skipped, update display again when the meal minute
+    // is over
+    Sched.runIn(TkNextMeal, MEAL_UPDATE_DELAY);
   }
 }
 
 
 /*
- *   Prepares an event to update the time in the LCD.
+ *   Task: updates the next meal in the model and LCD.
  */
-static Event eventTime()
+static void taskNextMeal()
 {
-  // Create an event that contains the official time from the RTC
-  Event E(Event::EvTime);
-  E.Time = Rtc.getOfficial();
+  updateNextMeal();
+  notify(Event::EvNextMeal);
+}
+
 
-  // Return the event
-  return E;
+/*
+ *   Task: saves a changed meal to EEPROM, rescheduling itself while there
+ *  are more.
+ */
+static void taskFlush()
+{
+  if (FeedData.flushMeal())
+    Sched.runIn(TkFlush, 0UL);
 }
 
 
 /*
- *   Prepares an event to update LCD display next meal info
+ *   Task: renders blinking phases flipped by the timer ISR.
  */
-static Event eventNextMeal()
+static void taskDisplay()
 {
-  // Create event to update the next meal in the LCD 
-  Event E(Event::EvNextMeal);
-  E.NextMeal.Status = FeedData.timeOfNext(&E.NextMeal.Dotw, &E.NextMeal.Hour,
-    &E.NextMeal.Minute);
+  PROF_SECTION(Prof::SeDisplayRefresh);
+  Lcd.refresh();
+}
 
-  // Return the event
-  return E;
+
+#ifdef ENABLE_DIAG_SERIAL
+/*
+ *   Task: prints the SRAM use over serial and, when profiling, the timing of
+ *  the sections. A line per run, letting the port send each one before the
+ *  next to keep within the budget.
+ */
+static void taskDiag()
+{
+#ifdef ENABLE_PROFILING
+  static uint8_t Line;  // Next line to print: 0 memory, then sections
+
+  if (Line)
+    Prof::printSection(Serial, (Prof::SectionId) (Line - 1U));
+  else
+    MemDiag::print(Serial);
+
+  // More sections? Otherwise start over next period
+  if (++Line <= Prof::SeNum)
+    Sched.runIn(TkDiag, DIAG_SERIAL_LINE_MS);
+  else
+  {
+    Line = 0U;
+    Sched.runEvery(TkDiag, DIAG_SERIAL_INTERVAL, DIAG_SERIAL_INTERVAL);
+  }
+#else
+  MemDiag::print(Serial);
+#endif
 }
 
 
 /*
- *   Sends an event E to the LCD display and handles actions unchained by it.
- *  Parameters:
- *  * E: event to send to the LCD display
- *  Returns:
- *  * false: we are not manually feeding
- *  * true: we are manually feeding
+ *   Prints over serial the size of the static objects of each module, the
+ *  bulk of .data and .bss. The linker map (avr-nm --size-sort) has the rest.
  */
-static bool sendEventAndHandleActions(Event E)
+static void printModuleSizes()
 {
-  bool End = false;
-  bool Feeding = false;
-  Action A;
+  Serial.print(F("feeds="));
+  Serial.print(sizeof FeedData);
+  Serial.print(F(" switchpnl="));
+  Serial.print(sizeof SwitchPanel);
+  Serial.print(F(" clock="));
+  Serial.print(sizeof Rtc);
+  Serial.print(F(" uimodel="));
+  Serial.print(sizeof Model);
+  Serial.print(F(" display="));
+  Serial.print(sizeof Lcd);
+  Serial.print(F(" auger="));
+  Serial.print(sizeof Edsm);
+  Serial.print(F(" scheduler="));
+  Serial.print(sizeof Sched);
+  Serial.print(F(" events="));
+  Serial.println(sizeof Events);
+}
+#endif  // ENABLE_DIAG_SERIAL
 
-  // Loop until no more actions requested or no more events needed
-  do
+
+/*
+ *   Reads the time from the RTC into the model. As only hours and minutes are
+ *  displayed, it also schedules the next time update for when the minute
+ *  changes.
+ */
+static void updateTime()
+{
   {
-    // Send event and record new requested action
-    A = Lcd.event(E);
-  
-    // Check the requested action, perform it and prepare new event when needed
-    switch (A.Id)
-    {
-    case Action::AcNone:
-      End = true;
-      break;
-    case Action::AcNeedTime:
-      E = eventTime();
-      break;
-    case Action::AcNeedNextMeal:
-      E = eventNextMeal();
-      break;
-    case Action::AcNeedTimeUtc:
-      E.Id = Event::EvTimeUtc;
-      E.Time = Rtc.getUtc();
-      break;
-    case Action::AcNeedMeal:
-      E.Id = Event::EvMeal;
-      E.pMeal = FeedData.getMeal(A.MealId);
-      break;
-    case Action::AcSetTimeUtc:
-      Rtc.setUtc(A.Time);
-      FeedData.reset(Rtc.getOfficial());  // Reset skip & calculate next meal
-      End = true;
-      break;
-    case Action::AcSetMeal:
-      FeedData.saveMeal(A.MealId);        // Save meal data to EEPROM
-      FeedData.reset(Rtc.getOfficial());  // Reset skip & calculate next meal
-      End = true;
-      break;
-    case Action::AcManualFeedStart:
-      Edsm.startFeeding();
-      Feeding = true;
-      End = true;
-      break;
-    case Action::AcManualFeedContinue:
-      // No Edsm feeding here, it is handled by the caller
-      Feeding = true;
-      End = true;
-      break;
-    case Action::AcManualFeedEnd:
-      Edsm.endFeeding();
-      // Feeding = false;
-      End = true;
-      break;
-    case Action::AcSkipMeal:
-      if (FeedData.isSkippingNext())
-        FeedData.unskipNext();
-      else
-        FeedData.skipNext();
-      End = true;
-      break;
-    case Action::AcReset:
-      FeedData.resetEeprom();  // Invalidate meal data in EEPROM
-      reboot();                // Reboot the Arduino
-      End = true;
-      break;
-    }
-  } while (!End);
+    PROF_SECTION(Prof::SeRtcRead);
+    // Single RTC read, the official time is calculated from it
+    Model.TimeUtc = Rtc.getUtc();
+    Model.Time = Rtc.utcToOfficial(Model.TimeUtc);
+  }
+  Model.TimeMillis = millis();
 
-  // Return whether we are manually feeding
-  return Feeding;
+  // Next update at the start of the next minute. The RTC has no sub-second
+  // resolution, so it will be up to 1s late, never early but for clock drift
+  // (then it reads second 59 and retries a second later)
+  Sched.runIn(TkTime, (60UL - Model.Time.second()) * 1000UL);
 }
 
 
 /*
- *   Checks whether it is time for a meal, serves it and updates the
- *  next meal in the FeedData object and LCD.
- *  Returns:
- *  * true: when a meal is served next meal needs to be updated in the LCD
- *    in a minute at lease.
- *  * false: no meal was served, no further updates required.
+ *   Updates the next meal info in the model.
  */
-static bool checkFeedTime()
+static void updateNextMeal()
 {
-  int8_t Quantity;
-  bool MealServed = false;
+  Model.NextMeal.Status = FeedData.timeOfNext(&Model.NextMeal.Dotw,
+    &Model.NextMeal.Hour, &Model.NextMeal.Minute);
+}
 
-  // Get current official time from the RTC and check whether it is meal time
-  Quantity = FeedData.check(Rtc.getOfficial());
 
-  // It is meal time when the quantity is not 0
-  if (Quantity)
-  {
-    // Positive quantity is meal amount, negative when we are skipping the meal
-    if (Quantity > 0)
-      // Deliver meal
-      Edsm.feed(Quantity);
+/*
+ *   Queues a switch event for the display and schedules its dispatch. The
+ *  queue must not be full.
+ *  Parameters:
+ *  * E: event to post.
+ */
+static void postEvent(const Event &E)
+{
+  Events.push(E);
+  Sched.runIn(TkEvents, 0UL);
+}
 
-    // Update LCD
-    sendEventAndHandleActions(eventNextMeal());
 
-    // Both when served and skipped, signal to update display later
-    MealServed = true;
+/*
+ *   Notifies the display of a model change and schedules its dispatch. It is
+ *  merged with a pending one of the same type.
+ *  Parameters:
+ *  * EvId: type of model change, not EvSwitch.
+ */
+static void notify(Event::EventId EvId)
+{
+  Notices |= _BV(EvId);
+  Sched.runIn(TkEvents, 0UL);
+}
+
+
+/*
+ *   Sends an event E to the LCD display and handles actions unchained by it.
+ *  Parameters:
+ *  * E: event to send to the LCD display
+ */
+static void sendEventAndHandleActions(const Event &E)
+{
+  Action A;
+
+  // Send event and get the requested action: pages read their data from the
+  // model, so a single event never needs further events to complete
+  {
+    PROF_SECTION(Prof::SeDisplayEvent);
+    A = Lcd.event(E);
   }
 
-  return MealServed;
+  // Check the requested action and perform it
+  switch (A.Id)
+  {
+  case Action::AcNone:
+    break;
+  case Action::AcSetTimeUtc:
+    Rtc.setUtc(DateTime(A.TimeUtc));
+    updateTime();                // Model time, resync with new minute
+    FeedData.reset(Model.Time);  // Reset skip & calculate next meal
+    updateNextMeal();
+    break;
+  case Action::AcSetMeal:
+    // Save meal data to EEPROM when config is over or after some idle time,
+    // all the changes at once. The meal is already in effect
+    FeedData.setMealDirty(A.MealId);
+    Configuring = true;
+    Sched.runIn(TkFlush, MEAL_FLUSH_IDLE_DELAY);
+    FeedData.reset(Model.Time);   // Reset skip & calculate next meal
+    updateNextMeal();
+    break;
+  case Action::AcManualFeedStart:
+    Edsm.startFeeding();
+    History.append(FeedLog::TyManual, 0U, Model.utcNow().unixtime());
+    break;
+  case Action::AcManualFeedContinue:
+    // Nothing to do, the timer interrupt keeps feeding
+    break;
+  case Action::AcManualFeedEnd:
+    Edsm.endFeeding();
+    break;
+  case Action::AcSkipMeal:
+    if (FeedData.isSkippingNext())
+      FeedData.unskipNext();
+    else
+      FeedData.skipNext();
+    updateNextMeal();
+    break;
+  case Action::AcConfigEnd:
+    // Save the changed meals now
+    Configuring = false;
+    if (FeedData.isDirty())
+      Sched.runIn(TkFlush, 0UL);
+    break;
+  case Action::AcReset:
+    FeedData.resetEeprom();  // Invalidate meal data in EEPROM
+    reboot();                // Reboot the Arduino
+    break;
+  }
 }
 
 
@@ -341,6 +585,24 @@ static void initClock()
 }
 
 
+/*
+ *   Stops the CPU in idle sleep mode until an interrupt wakes it up: switch
+ *  pin changes, the Timer1 blinking or the Timer0 millis() tick, which
+ *  wakes it every ms at most. Tasks are due on millis() times, so no task is
+ *  delayed, and an event raised by an ISR just before sleeping waits 1 ms.
+ *   Deeper modes are not usable: power-save and power-down stop Timer0, so
+ *  millis() would stop, and there is no asynchronous Timer2 crystal nor RTC
+ *  square wave output wired to wake up on time.
+ */
+static void sleepIdle()
+{
+  set_sleep_mode(SLEEP_MODE_IDLE);
+  sleep_enable();
+  sleep_cpu();
+  sleep_disable();
+}
+
+
 /*
  *   Reboots the Arduino by triggering the watchdog.
  */
@@ -76,7 +76,7 @@ DateTime Clock::getUtc() const
  */
 DateTime Clock::getOfficial() const
 {
-  return _utcToOfficial(_Rtc.now());
+  return utcToOfficial(_Rtc.now());
 }
 
 
@@ -87,14 +87,16 @@ DateTime Clock::getOfficial() const
  *  * UtcTime: UTC time to convert
  *  Returns: the official time for UtcTime.
  */
-DateTime Clock::_utcToOfficial(DateTime UtcTime) const
+DateTime Clock::utcToOfficial(const DateTime &UtcTime) const
 {
   DateTime OfficialTime;
 
+  // Casting needed because DateTime::operator+ is incorrectly declared
+  // without const
   if (_inDst(UtcTime))
-    OfficialTime = UtcTime + _Timezone + _DST_DIFFERENCE;
+    OfficialTime = (DateTime &) UtcTime + _Timezone + _DST_DIFFERENCE;
   else
-    OfficialTime = UtcTime + _Timezone;
+    OfficialTime = (DateTime &) UtcTime + _Timezone;
 
   return OfficialTime;
 }
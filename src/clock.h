@@ -21,6 +21,7 @@ public:
   void setUtc(const DateTime &UtcTime) const;
   DateTime getUtc() const;
   DateTime getOfficial() const;
+  DateTime utcToOfficial(const DateTime &UtcTime) const;
 
 protected:
   // Constants
@@ -46,7 +47,6 @@ protected:
   RTC_DS1307 _Rtc;
 
   // Methods
-  DateTime _utcToOfficial(DateTime UtcTime) const;
   bool _inDst(const DateTime &UtcTime) const;
   uint8_t _getLastDowOfMonth(uint16_t Year, uint8_t Month, uint8_t LastDom,
     uint8_t Dow) const;
@@ -4,6 +4,14 @@
 #define NDEBUG
 #define __ASSERT_USE_STDERR
 
+// Uncomment to time loop(), ISRs and subsystems (see prof.h). The timings are
+// printed over the serial port along with the SRAM use
+//#define ENABLE_PROFILING
+
+// Uncomment to print the SRAM use (see memdiag.h) over the serial port. It
+// keeps the USART powered and its buffers take about 160 bytes of SRAM
+//#define ENABLE_DIAG_SERIAL
+
 #include <Arduino.h>
 
 
@@ -11,6 +19,9 @@
  *   Define constants for general program configuration.
  */
 
+// Language of the texts in the display: LOCALE_ES or LOCALE_EN
+#define LOCALE_ES
+
 // Total number of meals that can be configured
 static const uint8_t NUM_MEALS = 8U;
 
@@ -32,19 +43,73 @@ static const uint8_t AUGER_EIGHTH_REVS_BACKUP = 1U;
 // FEED interval check in ms
 static const unsigned long FEED_CHECK_INTERVAL = 5000UL;
 
-// Main page time refresh in ms
-static const unsigned long TIME_UPDATE_INTERVAL = 1000UL;
-
-// Iterations reading switch panel per loop() call
-static const uint16_t SWITCH_LOOP_CNT = 500U;
-
-// How many reads of the switches status to perform waiting fot them to
-// stabilize their values (mainly for manual feed button release)
-static const uint16_t SWITCH_STAB_LOOP_CNT = 50U;
+// Switch panel interval check in ms
+static const unsigned long SWITCH_CHECK_INTERVAL = 5UL;
+
+// Display refresh (blinking) interval in ms
+static const unsigned long DISPLAY_REFRESH_INTERVAL = 20UL;
+
+// Time in ms between blinking phases of the widget with the focus
+static const uint16_t DISPLAY_BLINK_MS = 333U;
+
+// Serial port speed and interval in ms between SRAM reports, when enabled.
+// With profiling, a line with the timing of each section follows, one every
+// DIAG_SERIAL_LINE_MS ms, the time the port takes to send one
+static const unsigned long DIAG_SERIAL_BAUD = 9600UL;
+static const unsigned long DIAG_SERIAL_INTERVAL = 60000UL;
+static const unsigned long DIAG_SERIAL_LINE_MS = 100UL;
+
+// Maximum number of tasks in the scheduler
+#ifdef ENABLE_DIAG_SERIAL
+static const uint8_t SCHED_MAX_TASKS = 9U;
+#else
+static const uint8_t SCHED_MAX_TASKS = 8U;
+#endif
+
+// Switch events waiting to be dispatched to the display, plus one (power of
+// 2). Must hold all those pending in the switch panel: see catfeeder.ino
+static const uint8_t EVENT_QUEUE_SIZE = 16U;
+
+// Time budgets of the tasks in us: no task should take longer per run
+static const uint16_t EVENT_BUDGET_US = 5000U;     // Includes page redraws
+static const uint16_t MEALS_BUDGET_US = 5000U;     // Over on EEPROM init
+static const uint16_t SWITCH_BUDGET_US = 500U;
+static const uint16_t DISPLAY_BUDGET_US = 2000U;
+static const uint16_t TIME_BUDGET_US = 5000U;      // RTC read and redraw
+static const uint16_t FEED_BUDGET_US = 5000U;
+static const uint16_t NEXTMEAL_BUDGET_US = 3000U;
+static const uint16_t FLUSH_BUDGET_US = 25000U;    // 6 EEPROM bytes, 1 meal
+static const uint16_t DIAG_BUDGET_US = 60000U;     // Serial at 9600 bauds
+
+// Rotary encoder acceleration of number widgets. Detents less than
+// WGINT_ACCEL_FAST_MS ms apart change the value in WGINT_ACCEL_FAST_STEP units,
+// less than WGINT_ACCEL_MEDIUM_MS ms apart in WGINT_ACCEL_MEDIUM_STEP units
+// and slower ones in 1 unit. Times must be below 255 ms
+static const uint8_t WGINT_ACCEL_FAST_MS = 40U;
+static const uint8_t WGINT_ACCEL_FAST_STEP = 10U;
+static const uint8_t WGINT_ACCEL_MEDIUM_MS = 120U;
+static const uint8_t WGINT_ACCEL_MEDIUM_STEP = 5U;
+
+// Time in ms that a button must keep its level after its last change (bounce)
+// to register the change
+static const uint8_t SWITCH_SETTLE_MS_ENTER = 5U;
+static const uint8_t SWITCH_SETTLE_MS_BACK = 10U;
+
+// Button presses and releases registered while the main loop is busy, plus
+// one (power of 2)
+static const uint8_t SWITCH_EDGE_QUEUE_SIZE = 8U;
+
+// Time in ms holding Enter in the main page to open the diagnostics page
+// instead of the config page
+static const unsigned long DIAG_HOLD_MS = 3000UL;
+
+// Time in ms without using the switches after a meal change to save it to
+// EEPROM, if the config pages are not left before
+static const unsigned long MEAL_FLUSH_IDLE_DELAY = 60UL * 1000UL;
 
 // Time sice a meal is served to update the LCD next meal information in ms
-// It must be MEAL_UPDATE_DELAY > 60000 + TIME_UPDATE_INTERVAL
-static const uint16_t MEAL_UPDATE_DELAY = 5U * 60U * 1000U;
+// It must be MEAL_UPDATE_DELAY > 60000 + 1000 (meal minute + time refresh)
+static const unsigned long MEAL_UPDATE_DELAY = 5UL * 60UL * 1000UL;
 
 // Display size
 static const uint8_t DISPLAY_ROWS = 2U;
@@ -0,0 +1,27 @@
+#include "config.h"
+#include <util/crc16.h>
+#include "crcutil.h"
+
+
+/***********/
+/* Methods */
+/***********/
+
+/*
+ *   Calculates the CRC-16 of a block of memory.
+ *  Parameters:
+ *  * pData: data to check.
+ *  * Size: size of the data in bytes.
+ *  Returns: the CRC, starting from 0xFFFF so that a block of zeros does not
+ *  check as valid with a CRC of 0.
+ */
+uint16_t CrcUtil::crc16(const void *pData, uint8_t Size)
+{
+  const uint8_t *pByte = (const uint8_t *) pData;
+  uint16_t Crc = 0xFFFFU;
+
+  while (Size--)
+    Crc = _crc16_update(Crc, *pByte++);
+
+  return Crc;
+}
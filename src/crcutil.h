@@ -0,0 +1,20 @@
+#ifndef _CRCUTIL_H_
+#define _CRCUTIL_H_
+
+#include "config.h"
+#include <Arduino.h>
+
+
+/*
+ *   Static class to calculate the checksums of the records stored in the
+ *  EEPROM: CRC-16 (polynomial 0xA001) from avr-libc.
+ */
+class CrcUtil
+{
+public:
+  // Methods
+  static uint16_t crc16(const void *pData, uint8_t Size);
+};
+
+
+#endif  // _CRCUTIL_H_
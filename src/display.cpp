@@ -1,18 +1,62 @@
 #include "config.h"
 #include <assert.h>
+#include <new.h>
 #include "display.h"
+#include "uitext.h"
+
+
+/********************/
+/* Static variables */
+/********************/
+
+// LCD shared by pages and widgets
+LiquidCrystal *Page::_pLcd;
+LiquidCrystal *Widget::_pLcd;
+
+// Data model shown by the pages
+const UiModel *Page::_pModel;
+
+
+/********************/
+/* Member constants */
+/********************/
+
+// Page tree: parent of each page, indexed by Page::PageId
+const Page::PageId Display::_PARENT_PAGE[] PROGMEM =
+{
+  Page::PgIdNone,    // PgIdNone
+  Page::PgIdNone,    // PgIdMain
+  Page::PgIdMain,    // PgIdConfig
+  Page::PgIdConfig,  // PgIdMeal
+  Page::PgIdConfig,  // PgIdTime
+  Page::PgIdMain     // PgIdDiag
+};
+
+
+/***********/
+/* Methods */
+/***********/
 
 /*
  *   Constructor. Initializes LCD and window management structure, setting
  *  the focus to the main window.
+ *  Parameters:
+ *  * pModel: data model drawn by the pages, kept up to date by the caller.
+ *  * PinXxx: LCD pins.
  */
-Display::Display(uint8_t PinRs, uint8_t PinEnable, uint8_t PinD4, uint8_t PinD5,
-    uint8_t PinD6, uint8_t PinD7):
-  _Lcd(PinRs, PinEnable, PinD4, PinD5, PinD6, PinD7),
-  _PgMain(_Lcd),
-  _pFocusPage(&_PgMain)
+Display::Display(const UiModel *pModel, uint8_t PinRs, uint8_t PinEnable,
+    uint8_t PinD4, uint8_t PinD5, uint8_t PinD6, uint8_t PinD7):
+  _Lcd(PinRs, PinEnable, PinD4, PinD5, PinD6, PinD7)
 {
   _Lcd.begin(DISPLAY_COLS, DISPLAY_ROWS);
+
+  // Share the LCD and the model with all the pages and widgets
+  Page::_pLcd = &_Lcd;
+  Widget::_pLcd = &_Lcd;
+  Page::_pModel = pModel;
+
+  // Build main page, it has the focus
+  _buildPage(Page::PgIdMain);
 }
 
 
@@ -25,16 +69,19 @@ Action Display::event(const Event &E)
   PageAction PgA;
 
   // Pass event to focus page
-  PgA = _pFocusPage->event(E);
+  PgA = _eventPage(E);
+
+  // Going back: look up the parent in the page tree. The main page is the
+  // root and has none (PgIdNone), so going back from it is ignored
+  if (PgA.FocusPage == Page::PgIdParent)
+    PgA.FocusPage = (Page::PageId) pgm_read_byte(_PARENT_PAGE + _FocusPage);
 
   // Is there a focus change?
-  if (PgA.pFocusPage != nullptr)
+  if (PgA.FocusPage != Page::PgIdNone)
   {
-    assert(PgA.pFocusPage != _pFocusPage);  // Focus really changes
-
-    // Update focus page and draw it
-    _pFocusPage = PgA.pFocusPage;
-    PageAction PgAFocus = _pFocusPage->focus();
+    // Replace focus page with the new one and draw it
+    _buildPage(PgA.FocusPage);
+    PageAction PgAFocus = _focusPage();
 
     // First action overrides focus action: copy only if no action
     if (PgA.MainAction.Id == Action::AcNone)
@@ -46,6 +93,40 @@ Action Display::event(const Event &E)
 }
 
 
+/*
+ *   Performs pending LCD updates of the focus page, like widget blinking.
+ *  Called periodically from the main loop so the LCD is never accessed from
+ *  an interrupt.
+ */
+void Display::refresh()
+{
+#pragma GCC diagnostic push
+// Disable: warning: enumeration value 'PgIdNone' not handled in switch
+#pragma GCC diagnostic ignored "-Wswitch"
+
+  switch (_FocusPage)
+  {
+  case Page::PgIdMain:
+    _Arena.Main.refresh();
+    break;
+  case Page::PgIdConfig:
+    _Arena.Config.refresh();
+    break;
+  case Page::PgIdMeal:
+    _Arena.Meal.refresh();
+    break;
+  case Page::PgIdTime:
+    _Arena.Time.refresh();
+    break;
+  case Page::PgIdDiag:
+    _Arena.Diag.refresh();
+    break;
+  }
+
+#pragma GCC diagnostic pop
+}
+
+
 /*
  *  Shows a message in the display indicating that it is being reset.
  */
@@ -53,7 +134,7 @@ void Display::resetMessage()
 {
   // Clear the display and show the message
   _Lcd.clear();
-  _Lcd.print(F("REINICIALIZANDO"));
+  _Lcd.print((const __FlashStringHelper *) UiText::MSG_RESET);
   // Prepare cursor for animation
   _Lcd.setCursor(0, 1);
 }
@@ -99,6 +180,123 @@ void Display::error(const __FlashStringHelper *pMsg)
 void Display::_error()
 {
   _Lcd.clear();
-  _Lcd.print(F("ERROR:"));
+  _Lcd.print((const __FlashStringHelper *) UiText::MSG_ERROR);
   _Lcd.setCursor(0, 1);
 }
+
+
+/*
+ *   Builds a page in the arena, overwriting the one that was there, and
+ *  gives it the focus. Pages are trivially destructible, so the old one is
+ *  just discarded.
+ *  Parameters:
+ *  * PgId: identifier of the page to build, an actual page: neither
+ *    PgIdNone nor PgIdParent.
+ */
+void Display::_buildPage(Page::PageId PgId)
+{
+#pragma GCC diagnostic push
+// Disable: warning: enumeration value 'PgIdNone' not handled in switch
+#pragma GCC diagnostic ignored "-Wswitch"
+
+  switch (PgId)
+  {
+  case Page::PgIdMain:
+    new (&_Arena.Main) PgMain();
+    break;
+  case Page::PgIdConfig:
+    new (&_Arena.Config) PgConfig();
+    break;
+  case Page::PgIdMeal:
+    new (&_Arena.Meal) PgMeal();
+    break;
+  case Page::PgIdTime:
+    new (&_Arena.Time) PgTime();
+    break;
+  case Page::PgIdDiag:
+    new (&_Arena.Diag) PgDiag();
+    break;
+  default:
+    assert(false);
+  }
+
+#pragma GCC diagnostic pop
+
+  _FocusPage = PgId;
+}
+
+
+/*
+ *   Calls the focus() method of the page with the focus.
+ *  Returns: the PageAction returned by the page.
+ */
+PageAction Display::_focusPage()
+{
+  PageAction PgA;
+
+#pragma GCC diagnostic push
+// Disable: warning: enumeration value 'PgIdNone' not handled in switch
+#pragma GCC diagnostic ignored "-Wswitch"
+
+  switch (_FocusPage)
+  {
+  case Page::PgIdMain:
+    PgA = _Arena.Main.focus();
+    break;
+  case Page::PgIdConfig:
+    PgA = _Arena.Config.focus();
+    break;
+  case Page::PgIdMeal:
+    PgA = _Arena.Meal.focus();
+    break;
+  case Page::PgIdTime:
+    PgA = _Arena.Time.focus();
+    break;
+  case Page::PgIdDiag:
+    PgA = _Arena.Diag.focus();
+    break;
+  }
+
+#pragma GCC diagnostic pop
+
+  return PgA;
+}
+
+
+/*
+ *   Passes an event to the page with the focus.
+ *  Parameters:
+ *  * E: event data
+ *  Returns: the PageAction returned by the page.
+ */
+PageAction Display::_eventPage(const Event &E)
+{
+  PageAction PgA;
+
+#pragma GCC diagnostic push
+// Disable: warning: enumeration value 'PgIdNone' not handled in switch
+#pragma GCC diagnostic ignored "-Wswitch"
+
+  switch (_FocusPage)
+  {
+  case Page::PgIdMain:
+    PgA = _Arena.Main.event(E);
+    break;
+  case Page::PgIdConfig:
+    PgA = _Arena.Config.event(E);
+    break;
+  case Page::PgIdMeal:
+    PgA = _Arena.Meal.event(E);
+    break;
+  case Page::PgIdTime:
+    PgA = _Arena.Time.event(E);
+    break;
+  case Page::PgIdDiag:
+    PgA = _Arena.Diag.event(E);
+    break;
+  }
+
+#pragma GCC diagnostic pop
+
+  return PgA;
+}
@@ -6,6 +6,10 @@
 #include <LiquidCrystal.h>
 #include "page.h"
 #include "pgmain.h"
+#include "pgconfig.h"
+#include "pgmeal.h"
+#include "pgtime.h"
+#include "pgdiag.h"
 
 
 /*
@@ -14,21 +18,41 @@
 class Display
 {
 public:
-  Display(uint8_t PinRs, uint8_t PinEnable, uint8_t PinD4, uint8_t PinD5,
-    uint8_t PinD6, uint8_t PinD7);
+  Display(const UiModel *pModel, uint8_t PinRs, uint8_t PinEnable,
+    uint8_t PinD4, uint8_t PinD5, uint8_t PinD6, uint8_t PinD7);
   Action event(const Event &E);
+  void refresh();
   void resetMessage();
   void resetAnimation();
   void error(const char *pMsg);
   void error(const __FlashStringHelper *pMsg);
 
 protected:
+  // Memory shared by all the pages: only the one with the focus is built.
+  // Its size is the one of the largest page
+  union PageArena
+  {
+    PageArena() {}
+
+    PgMain Main;
+    PgConfig Config;
+    PgMeal Meal;
+    PgTime Time;
+    PgDiag Diag;
+  };
+
+  // Page tree: parent of each page, indexed by Page::PageId
+  static const Page::PageId _PARENT_PAGE[] PROGMEM;
+
   void _error();
+  void _buildPage(Page::PageId PgId);
+  PageAction _focusPage();
+  PageAction _eventPage(const Event &E);
 
   // Member data
-  LiquidCrystal _Lcd;  // LCD control class
-  PgMain _PgMain;      // Main page
-  Page *_pFocusPage;   // Page currently having the focus to pass events
+  LiquidCrystal _Lcd;       // LCD control class
+  PageArena _Arena;         // Storage for the page with the focus
+  Page::PageId _FocusPage;  // Page currently having the focus to pass events
 };
 
 
@@ -6,21 +6,14 @@
 
 
 /*
- *   Static class to translate day of the week indexes into Spansh text.
- *  Defaults to index 0 representing Sunday. For localization purposes,
- *  constants with the local first day of the week are provided.
+ *   Static class to operate with day of the week indexes. Defaults to index 0
+ *  representing Sunday. Their text representations are in UiText.
  */
 class DotwUtil
 {
 public:
   // Public Constants
   static const uint8_t DAYS_IN_A_WEEK = 7U;
-  static const uint8_t FIRST_DOTW_ES = 1U;
-  static const uint8_t FIRST_DOTW_EN = 0U;
-
-  // Store day of the week representations in arrays (range [0,6])
-  static char DotwCharEs[DAYS_IN_A_WEEK];
-  //static char DotwCharEn[DAYS_IN_A_WEEK];
 
   // Methods
   static inline uint8_t incr(uint8_t &DotwId, uint8_t Increment);
@@ -0,0 +1,150 @@
+#include "config.h"
+#include <assert.h>
+#include <EEPROM.h>
+#include "eepring.h"
+
+
+/***********/
+/* Methods */
+/***********/
+
+/*
+ *   Constructor. The ring is empty until init() finds its latest record.
+ *  Parameters:
+ *  * Addr: EEPROM address of the area.
+ *  * Size: size of the area in bytes. Slots that do not fit are not used.
+ *  * RecSize: size of the record.
+ */
+EepRing::EepRing(int Addr, uint16_t Size, uint8_t RecSize):
+  _Addr(Addr),
+  _RecSize(RecSize),
+  _NumSlots(Size / (RecSize + 1U)),
+  _Head(_SLOT_NONE),
+  _Seq(0U)
+{
+  // At least 2 slots, so a write never overwrites the latest record, and
+  // fewer than sequences, so there is always a gap in them after the latest
+  assert(Size / (RecSize + 1U) >= 2U && Size / (RecSize + 1U) < _SEQ_MOD);
+}
+
+
+/*
+ *   Finds the latest record, reading the sequences of the slots.
+ */
+void EepRing::init()
+{
+  uint8_t Seq;
+
+  _Head = _SLOT_NONE;
+
+  for (uint8_t Slot = 0U; Slot < _NumSlots; Slot++)
+  {
+    Seq = EEPROM.read(_slotAddr(Slot));
+
+    // The latest record is not followed by the next sequence
+    if (Seq != _SEQ_EMPTY &&
+        EEPROM.read(_slotAddr(_nextSlot(Slot))) != _nextSeq(Seq))
+    {
+      _Head = Slot;
+      _Seq = Seq;
+      break;
+    }
+  }
+}
+
+
+/*
+ *   Empties the ring, marking all the slots as empty. Only the sequences are
+ *  written.
+ */
+void EepRing::format()
+{
+  for (uint8_t Slot = 0U; Slot < _NumSlots; Slot++)
+    EEPROM.update(_slotAddr(Slot), _SEQ_EMPTY);
+
+  _Head = _SLOT_NONE;
+}
+
+
+/*
+ *   Reads the latest record.
+ *  Parameters:
+ *  * pRec: where to copy the record.
+ *  Returns: true iff the ring is empty and nothing was read.
+ */
+bool EepRing::read(void *pRec) const
+{
+  uint8_t *pByte = (uint8_t *) pRec;
+  int Addr;
+
+  if (_Head == _SLOT_NONE)
+    return true;
+
+  Addr = _slotAddr(_Head) + 1;
+  for (uint8_t Idx = 0U; Idx < _RecSize; Idx++)
+    *pByte++ = EEPROM.read(Addr++);
+
+  return false;
+}
+
+
+/*
+ *   Writes a new record in the slot after the latest one, which becomes the
+ *  latest when its sequence is written, after the record.
+ *  Parameters:
+ *  * pRec: record to write.
+ */
+void EepRing::write(const void *pRec)
+{
+  const uint8_t *pByte = (const uint8_t *) pRec;
+  uint8_t Slot, Seq;
+  int Addr;
+
+  if (_Head == _SLOT_NONE)
+  {
+    Slot = 0U;
+    Seq = 0U;
+  }
+  else
+  {
+    Slot = _nextSlot(_Head);
+    Seq = _nextSeq(_Seq);
+  }
+
+  // Record first. The old sequence of the slot never follows _Seq, so the
+  // slot is not taken as the latest until the new one is written
+  Addr = _slotAddr(Slot);
+  for (uint8_t Idx = 0U; Idx < _RecSize; Idx++)
+    EEPROM.update(++Addr, *pByte++);
+  EEPROM.write(_slotAddr(Slot), Seq);
+
+  _Head = Slot;
+  _Seq = Seq;
+}
+
+
+/*
+ *   Returns the EEPROM address of a slot.
+ */
+int EepRing::_slotAddr(uint8_t Slot) const
+{
+  return _Addr + Slot * (_RecSize + 1U);
+}
+
+
+/*
+ *   Returns the slot after another one, cycling at the end.
+ */
+uint8_t EepRing::_nextSlot(uint8_t Slot) const
+{
+  return ++Slot < _NumSlots? Slot: 0U;
+}
+
+
+/*
+ *   Returns the sequence after another one, cycling before _SEQ_EMPTY.
+ */
+uint8_t EepRing::_nextSeq(uint8_t Seq)
+{
+  return ++Seq < _SEQ_MOD? Seq: 0U;
+}
@@ -0,0 +1,47 @@
+#ifndef _EEPRING_H_
+#define _EEPRING_H_
+
+#include "config.h"
+#include <Arduino.h>
+
+
+/*
+ *   Wear-leveled store of a frequently rewritten record in an EEPROM area.
+ *  The area is split in slots and every write goes to the slot after the
+ *  latest one, so each cell is written once every number of slots times.
+ *   Each slot is a sequence byte followed by the record. Sequences grow by 1
+ *  (modulo 255, 0xFF marks an empty slot) from slot to slot, so the latest
+ *  slot is the one whose next slot does not follow its sequence. It is found
+ *  once in init() and then kept, so read() and write() find it at once.
+ *  The sequence is written after the record: a write interrupted by a reset
+ *  leaves the previous record as the latest.
+ */
+class EepRing
+{
+public:
+  EepRing(int Addr, uint16_t Size, uint8_t RecSize);
+  void init();
+  void format();
+  bool read(void *pRec) const;
+  void write(const void *pRec);
+
+protected:
+  static const uint8_t _SEQ_EMPTY = 0xFFU;  // Erased EEPROM
+  static const uint8_t _SEQ_MOD = 0xFFU;    // Sequences in [0,254]
+  static const uint8_t _SLOT_NONE = UINT8_MAX;
+
+  // Protected methods
+  int _slotAddr(uint8_t Slot) const;
+  uint8_t _nextSlot(uint8_t Slot) const;
+  static uint8_t _nextSeq(uint8_t Seq);
+
+  // Member data
+  const int _Addr;          // EEPROM address of the first slot
+  const uint8_t _RecSize;   // Size of the record
+  const uint8_t _NumSlots;  // Number of slots in the area
+  uint8_t _Head;            // Slot with the latest record, or _SLOT_NONE
+  uint8_t _Seq;             // Sequence of the latest record
+};
+
+
+#endif  // _EEPRING_H_
@@ -3,13 +3,11 @@
 
 #include "config.h"
 #include <Arduino.h>
-#include <RTClib.h>
-#include "feeds.h"
 
 
 /*
  *   This header defines class Event, which is used to communicate to the
- *  Display events such as button actions or just requested data.
+ *  Display events such as button actions or changes in the UiModel data.
  */
 class Event
 {
@@ -23,95 +21,24 @@ public:
   {
     EvInit,     // Initialize, first draw
     EvSwitch,   // Switch (button) event
-    EvTime,     // Carrying a DateTime class
-    EvTimeUtc,  // Carrying a DateTime class
-    EvMeal,     // Carrying a Meal class
-    EvNextMeal  // Carrying info about the next meal
+    EvTime,     // UiModel time has been updated
+    EvNextMeal  // UiModel next meal has been updated
   };
 
   // In case of EvSwitch, which switch has the user activated
   enum SwitchEvent: uint8_t
   {
     SwEvNone=0,        // No input switch event
-    SwEvSelectCcw,     // Counterclockwise event on the Select encoder
-    SwEvSelectCw,      // Clockwise event on the Select encoder
+    SwEvSelect,        // Select encoder turned Steps detents
     SwEvEnterPress,    // Enter button press event (Select button pressed)
     SwEvEnterRelease,  // Enter button release event (Select button released)
     SwEvBackPress,     // Back button press event
     SwEvBackRelease    // Back button release event
   };
 
-  // Further data for EvNextMeal
-  struct NextMeal_t
-  {
-    uint8_t Dotw;  // Range [0,6] being 0 Sunday (like DateTime class)
-    uint8_t Hour;
-    uint8_t Minute;
-    Feeds::Next_t Status;
-  };
-
-  // Constructors
-  Event() {}
+  // Constructors. Trivially copyable: copied with no code per event type
+  Event() = default;
   Event(EventId EvId): Id(EvId) {}
-  
-  // Copy constructor
-  Event(const Event &Ev):
-    Id(Ev.Id)
-  {
-#pragma GCC diagnostic push
-// Disable: warning: enumeration value 'EvInit' not handled in switch
-#pragma GCC diagnostic ignored "-Wswitch"
-
-    switch (Id)
-    {
-    case EvSwitch:
-      Switch = Ev.Switch;
-      break;
-    case EvTime:
-    case EvTimeUtc:
-      Time = Ev.Time;
-      break;
-    case EvMeal:
-      pMeal = Ev.pMeal;
-      break;
-    case EvNextMeal:
-      NextMeal = Ev.NextMeal;
-      break;
-    }
-
-#pragma GCC diagnostic pop
-  }
-
-  // Assignment operator
-  Event & operator=(const Event &Ev)
-  {
-    Id = Ev.Id;
-
-#pragma GCC diagnostic push
-// Disable: warning: enumeration value 'EvInit' not handled in switch
-#pragma GCC diagnostic ignored "-Wswitch"
-
-    switch (Id)
-    {
-    case EvSwitch:
-      Switch = Ev.Switch;
-      break;
-    case EvTime:
-    case EvTimeUtc:
-      Time = Ev.Time;
-      break;
-    case EvMeal:
-      pMeal = Ev.pMeal;
-      break;
-    case EvNextMeal:
-      NextMeal = Ev.NextMeal;
-      break;
-    }
-
-#pragma GCC diagnostic pop
-
-    return *this;
-  }
 
 
   /***************/
@@ -119,14 +46,12 @@ public:
   /***************/
 
   EventId Id;
-  union
-  {
-    SwitchEvent Switch;   // Used by EvSwitch
-    DateTime Time;        // Used by EvTime, EvTimeUtc
-    Meal *pMeal;          // Used by EvMeal
-    NextMeal_t NextMeal;  // Used by EvNextMeal;
-  };
+  SwitchEvent Switch;  // Used by EvSwitch
+  int8_t Steps;        // Used by SwEvSelect: detents, positive clockwise
+  uint8_t DetentMs;    // Used by SwEvSelect: ms between its last 2 detents
 };
 
+static_assert(__is_pod(Event), "Event must be plain old data");
+
 
 #endif  // _EVENT_H_
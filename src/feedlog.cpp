@@ -0,0 +1,185 @@
+#include "config.h"
+#include <EEPROM.h>
+#include "feedlog.h"
+
+
+/***********/
+/* Methods */
+/***********/
+
+/*
+ *   Constructor. The log is empty until init() reads its index.
+ */
+FeedLog::FeedLog():
+  _IndexRing(_INDEX_ADDR, _INDEX_SIZE, sizeof (Index_t)),
+  _Index{0U, 0U, 0UL}
+{
+}
+
+
+/*
+ *   Reads the index of the log from EEPROM. A log never used, or with an
+ *  index out of range, is empty.
+ */
+void FeedLog::init()
+{
+  _IndexRing.init();
+  if (_IndexRing.read(&_Index) ||
+      _Index.Head >= _DATA_SIZE || _Index.Used > _DATA_SIZE)
+  {
+    _Index.Head = 0U;
+    _Index.Used = 0U;
+  }
+}
+
+
+/*
+ *   Appends an entry to the log, overwriting the oldest ones if full.
+ *  Parameters:
+ *  * Type: type of entry.
+ *  * Quantity: meal quantity, 0 when not known. Up to 15.
+ *  * TimeUtc: Unix time of the entry. Seconds are discarded.
+ */
+void FeedLog::append(Type_t Type, uint8_t Quantity, uint32_t TimeUtc)
+{
+  uint32_t Min = TimeUtc / 60UL;
+  uint32_t Value;
+  uint8_t Size;  // Bytes of Value - 1
+  uint16_t Pos;
+
+  // Delta with the previous entry in as few bytes as possible, or absolute
+  // time of the previous one if the clock went back
+  if (!_Index.Used)
+  {
+    Value = 0UL;  // First entry
+    Size = 0U;
+  }
+  else if (Min >= _Index.LastMin && Min - _Index.LastMin < 0x1000000UL)
+  {
+    Value = Min - _Index.LastMin;
+    Size = Value < 0x100UL? 0U: Value < 0x10000UL? 1U: 2U;
+  }
+  else
+  {
+    Value = _Index.LastMin;
+    Size = _SIZE_ABS;
+  }
+
+  // Append the value, little endian, and the last byte
+  Pos = _Index.Head;
+  for (uint8_t Idx = 0U; Idx <= Size; Idx++, Value >>= 8)
+  {
+    _writeByte(Pos, (uint8_t) Value);
+    Pos = _advance(Pos, 1U);
+  }
+  _writeByte(Pos, Type << _TYPE_SHIFT | (Quantity & _QTY_MASK) << _QTY_SHIFT |
+    Size);
+  Pos = _advance(Pos, 1U);
+
+  // Then the index: the entry is not in the log until it is written
+  _Index.Used += Size + 2U;
+  if (_Index.Used > _DATA_SIZE)
+    _Index.Used = _DATA_SIZE;
+  _Index.Head = Pos;
+  _Index.LastMin = Min;
+  _IndexRing.write(&_Index);
+}
+
+
+/*
+ *   Returns an iterator to read the log from the newest entry.
+ */
+FeedLog::Iterator FeedLog::newest() const
+{
+  Iterator It;
+
+  It._Pos = _Index.Head;
+  It._Left = _Index.Used;
+  It._Min = _Index.LastMin;
+
+  return It;
+}
+
+
+/*
+ *   Reads the next entry of the log, from the newest to the oldest. When the
+ *  log has wrapped, the oldest entry may be partially overwritten: the
+ *  iteration ends before it.
+ *  Parameters:
+ *  * pEntry: where to store the entry read.
+ *  Returns: true iff an entry was read, false at the end of the log.
+ */
+bool FeedLog::Iterator::next(Entry_t *pEntry)
+{
+  uint8_t Last, Size;
+  uint32_t Value = 0UL;
+  uint16_t Pos;
+
+  if (!_Left)
+    return false;
+
+  Last = _readByte(_back(_Pos, 1U));
+  Size = Last & _SIZE_MASK;
+  if (Last >> _TYPE_SHIFT == _TYPE_INVALID || Size + 2U > _Left)
+  {
+    _Left = 0U;
+    return false;
+  }
+
+  // Read the value, little endian: from its most significant byte backwards
+  Pos = _back(_Pos, 1U);
+  for (uint8_t Idx = 0U; Idx <= Size; Idx++)
+  {
+    Pos = _back(Pos, 1U);
+    Value = Value << 8 | _readByte(Pos);
+  }
+
+  pEntry->TimeUtc = _Min * 60UL;
+  pEntry->Type = (Type_t) (Last >> _TYPE_SHIFT);
+  pEntry->Quantity = Last >> _QTY_SHIFT & _QTY_MASK;
+
+  // Time of the previous entry
+  _Min = Size == _SIZE_ABS? Value: _Min - Value;
+  _Pos = Pos;
+  _Left -= Size + 2U;
+
+  return true;
+}
+
+
+/*
+ *   Reads a byte of the entries area.
+ */
+uint8_t FeedLog::_readByte(uint16_t Pos)
+{
+  return EEPROM.read(_DATA_ADDR + Pos);
+}
+
+
+/*
+ *   Writes a byte of the entries area.
+ */
+void FeedLog::_writeByte(uint16_t Pos, uint8_t Value)
+{
+  EEPROM.update(_DATA_ADDR + Pos, Value);
+}
+
+
+/*
+ *   Returns the position some bytes after another one, cycling at the end.
+ */
+uint16_t FeedLog::_advance(uint16_t Pos, uint16_t Bytes)
+{
+  Pos += Bytes;
+  return Pos < _DATA_SIZE? Pos: Pos - _DATA_SIZE;
+}
+
+
+/*
+ *   Returns the position some bytes before another one, cycling at the
+ *  start.
+ */
+uint16_t FeedLog::_back(uint16_t Pos, uint16_t Bytes)
+{
+  return Pos >= Bytes? Pos - Bytes: Pos + _DATA_SIZE - Bytes;
+}
@@ -0,0 +1,97 @@
+#ifndef _FEEDLOG_H_
+#define _FEEDLOG_H_
+
+#include "config.h"
+#include <Arduino.h>
+#include "eepring.h"
+
+
+/*
+ *   Circular log in EEPROM of the meals served and skipped and the manual
+ *  feeds, with their UTC time in minutes. Entries are only appended, the
+ *  oldest being overwritten when the log is full, and read from the newest
+ *  to the oldest with an Iterator.
+ *   To make the most of the EEPROM, each entry stores the time elapsed since
+ *  the previous one, in as few bytes as needed, followed by a byte with its
+ *  type, quantity and delta size. That byte is the last one so the log can
+ *  be read backwards. A meal a few hours after the previous one takes 3
+ *  bytes, 2 if within 255 minutes. When the clock was set back, the entry
+ *  stores the absolute time of the previous one instead.
+ *   The position and time of the newest entry are kept in a wear-leveled
+ *  index, written after the entry: an interrupted append is just lost.
+ */
+class FeedLog
+{
+public:
+  // Types of entry
+  enum Type_t: uint8_t
+  {
+    TyServed = 0U,  // Meal served
+    TySkipped,      // Meal skipped
+    TyManual        // Manual feed started
+  };
+
+  // Entry read from the log
+  struct Entry_t
+  {
+    uint32_t TimeUtc;  // Unix time, in whole minutes
+    Type_t Type;
+    uint8_t Quantity;  // Meal quantity, 0 when not known
+  };
+
+  // Reads the log from the newest entry to the oldest
+  class Iterator
+  {
+  public:
+    bool next(Entry_t *pEntry);
+
+  protected:
+    friend class FeedLog;
+
+    uint16_t _Pos;   // Position after the next entry to read
+    uint16_t _Left;  // Bytes of the log not read yet
+    uint32_t _Min;   // Time of the next entry to read, in minutes
+  };
+
+  FeedLog();
+  void init();
+  void append(Type_t Type, uint8_t Quantity, uint32_t TimeUtc);
+  Iterator newest() const;
+
+protected:
+  // EEPROM areas of the index and the entries
+  static const int _INDEX_ADDR = 256;
+  static const uint16_t _INDEX_SIZE = 64U;
+  static const int _DATA_ADDR = 320;
+  static const uint16_t _DATA_SIZE = 704U;
+
+  // Last byte of an entry: type, quantity and delta size (bytes - 1). The
+  // largest size holds the absolute time of the previous entry instead
+  static const uint8_t _TYPE_SHIFT = 6U;
+  static const uint8_t _QTY_SHIFT = 2U;
+  static const uint8_t _QTY_MASK = 0x0FU;
+  static const uint8_t _SIZE_MASK = 0x03U;
+  static const uint8_t _SIZE_ABS = 3U;
+  static const uint8_t _TYPE_INVALID = 3U;  // Erased EEPROM
+
+  // Index of the log
+  struct Index_t
+  {
+    uint16_t Head;    // Position after the newest entry
+    uint16_t Used;    // Bytes with entries before Head, up to _DATA_SIZE
+    uint32_t LastMin; // Time of the newest entry, in minutes
+  };
+
+  // Protected methods
+  static uint8_t _readByte(uint16_t Pos);
+  static void _writeByte(uint16_t Pos, uint8_t Value);
+  static uint16_t _advance(uint16_t Pos, uint16_t Bytes);
+  static uint16_t _back(uint16_t Pos, uint16_t Bytes);
+
+  // Member data
+  EepRing _IndexRing;  // Persistent index
+  Index_t _Index;      // Current index
+};
+
+
+#endif  // _FEEDLOG_H_
@@ -1,7 +1,9 @@
 #include "config.h"
 #include <assert.h>
+#include <stddef.h>
 #include <EEPROM.h>
 #include "feeds.h"
+#include "crcutil.h"
 
 
 /*
@@ -10,47 +12,54 @@
 Feeds::Feeds():
   _NextMealId(_ID_NULL),
   _NextMealDealt(false),
-  _SkipNextMeal(false)
+  _SkipNextMeal(false),
+  _SkipSaved(false),
+  _DirtyMeals(0U),
+  _State(_STATE_ADDR, _STATE_SIZE, sizeof (State_t))
 {
   int Addr;
   uint8_t Id;
 
+  static_assert(_BASE_ADDR_V0 + NUM_MEALS * _MEAL_SIZE_V0 <= _HEADER_ADDR,
+    "Header overlaps version 0 meals in EEPROM");
+  static_assert(_HEADER_ADDR + sizeof (Header_t) <= _BASE_ADDR,
+    "Header overlaps the meals in EEPROM");
+  static_assert(_BASE_ADDR + NUM_MEALS * Meal::EEPROM_SIZE <= _STATE_ADDR,
+    "Meals overlap the state ring in EEPROM");
+
   // Initialize EEPROM address for each Meal object
-  for (Id=0, Addr=_BASE_ADDR; Id<NUM_MEALS; Id++, Addr+=sizeof (Meal))
+  for (Id=0, Addr=_BASE_ADDR; Id<NUM_MEALS; Id++, Addr+=Meal::EEPROM_SIZE)
     _Meals[Id].setEepromAddress(Addr);
 }
 
 
 /*
  *   Initializes class, reading meals from EEPROM (or initializing the
- *  EEPROM if never used) and setting the next feed.
+ *  EEPROM if never used or migrating it from an older layout) and setting
+ *  the next feed. A skip of the next meal saved before a reboot is restored
+ *  if it is still the next meal.
  *  Parameters:
  *  * Now: current time; next feed will be the first found after this time.
  */
 void Feeds::init(const DateTime &Now)
 {
-  uint8_t Id;
-
-  // Read magic record and check for validity
-  if (EEPROM.read(_MAGIC_ADDR) != _MAGIC_NUMBER)
-  {
-    // Magic record has incorrect value -> initialize EEPROM data
-    // First write meals data
-    for (Id=0; Id<NUM_MEALS; Id++)
-      _Meals[Id].saveEeprom();
-
-    // Then write valid magic number
-    EEPROM.write(_MAGIC_ADDR, _MAGIC_NUMBER);
-  }
+  Header_t Header;
+
+  // Read header and check for validity. Later layout versions will migrate
+  // the older ones here, before loading the meals
+  EEPROM.get(_HEADER_ADDR, Header);
+  if (_isValid(Header) && Header.Version == _VERSION)
+    _loadMeals(Header.Count);
+  else if (EEPROM.read(_MAGIC_ADDR_V0) == _MAGIC_NUMBER_V0)
+    _migrateV0();
   else
-  {
-    // Magic number is correct, read saved meals from EEPROM
-    for (Id=0; Id<NUM_MEALS; Id++)
-      _Meals[Id].loadEeprom();
-  }
+    // Never used, corrupt or unknown version -> initialize EEPROM data
+    _format();
 
   // Set next (first) meal
+  _State.init();
   _updateNext(Now);
+  _loadSkip();
 }
 
 
@@ -60,7 +69,7 @@ void Feeds::init(const DateTime &Now)
 void Feeds::resetEeprom()
 {
   // Unset the magic number, e.g. writing its value inverted
-  EEPROM.write(_MAGIC_ADDR, (uint8_t) ~_MAGIC_NUMBER);
+  EEPROM.write(_HEADER_ADDR, (uint8_t) ~_MAGIC_NUMBER);
 }
 
 
@@ -73,7 +82,7 @@ void Feeds::resetEeprom()
  */
 void Feeds::reset(const DateTime &Now)
 {
-  _SkipNextMeal = false;
+  _setSkip(false);
   _NextMealDealt = false;
 
   // Calcule next meal again
@@ -85,6 +94,10 @@ void Feeds::reset(const DateTime &Now)
 /*
  *   Check whether it is time for a meal and returns the quantity to deliver.
  *  It also updates the object for the next meal.
+ *   Times are compared as instants, not as matching day and time: when DST
+ *  starts, the meals in the skipped hour are served as soon as the hour is
+ *  over, one per call, and when it ends, meals in the repeated hour are not
+ *  served twice, as the next meal is already later than the repeated times.
  *  Parameters:
  *  * Now: current official time
  *  Returns:
@@ -95,52 +108,41 @@ void Feeds::reset(const DateTime &Now)
 int8_t Feeds::check(const DateTime &Now)
 {
   uint8_t Quantity = 0U;
-  const Meal *pMeal;
+  uint32_t NowTime = Now.unixtime();
 
   // Is there a next feed?
   if (_NextMealId != _ID_NULL)
   {
     // First we check if the next meal needs to be reset. This happens when
-    // this is the first call after (not matching time of) a meal that has
-    // already been dealt with
-    if (_NextMealDealt && !_Meals[_NextMealId].matchesTime(Now))
+    // this is the first call after the minute of a meal that has already
+    // been dealt with. The next one is the first after the dealt one, not
+    // after Now: after the hour skipped by DST it can be overdue too
+    if (_NextMealDealt && NowTime >= _NextMealTime + 60UL)
       // Reset changes _NextMealId, _NextMealDealt & _SkipNextMeal
-      reset(Now);
+      reset(DateTime(_NextMealTime));
 
     // Once next meal is reset (or not), check normally
     // Even when reset, we know that there is at least one meal available:
     // the very dealt meal in one week time, so assert it:
     assert(_NextMealId != _ID_NULL);
 
-    pMeal = _Meals + _NextMealId;
-
-    // Does next meal match the current day and time?
-    if (pMeal->matchesTime(Now))
+    // Has the next meal time come? It may have passed already
+    if (!_NextMealDealt && NowTime >= _NextMealTime)
     {
-      if (!_NextMealDealt)
+      // First time at (or past) the meal time, deal with it
+      _NextMealDealt = true;
+
+      if (!_SkipNextMeal)
+        Quantity = _Meals[_NextMealId].getQuantity();
+      else
       {
-        // First time matching the meal time, deal with it
-        _NextMealDealt = true;
-
-        if (!_SkipNextMeal)
-          Quantity = pMeal->getQuantity();
-        else
-        {
-          // Reset skip for the next to this one we are skipping
-          _SkipNextMeal = false;
-          // It was meal time but it was skipped
-          Quantity = -1;
-        }
+        // Reset skip for the next to this one we are skipping
+        _setSkip(false);
+        // It was meal time but it was skipped
+        Quantity = -1;
       }
-      // else: already checked this very minute, Quantity = 0
-    }
-    else
-    {
-      // Because we already checked this and did a reset() in that case
-      assert(!_NextMealDealt);  
-
-      // Times are different -> Quantity = 0
     }
+    // else: not yet, or already dealt with this minute -> Quantity = 0
   }
   // else: no meals active -> Quantity = 0
 
@@ -156,7 +158,7 @@ void Feeds::skipNext()
 {
   // If there is no programmed next meal, do nothing
   if (_NextMealId != _ID_NULL)
-    _SkipNextMeal = true;
+    _setSkip(true);
 }
 
 
@@ -165,7 +167,7 @@ void Feeds::skipNext()
  */
 void Feeds::unskipNext()
 {
-  _SkipNextMeal = false;
+  _setSkip(false);
 }
 
 
@@ -232,13 +234,45 @@ Meal *Feeds::getMeal(uint8_t Id)
 
 
 /*
- *   Saves meal data to EEPROM.
+ *   Marks a meal as changed, to be saved to EEPROM later by flushMeal(). The
+ *  change is already in effect: the EEPROM only keeps it across reboots.
  *  Parameters:
  *  * Id: meal identifier.
  */
-void Feeds::saveMeal(uint8_t Id)
+void Feeds::setMealDirty(uint8_t Id)
+{
+  assert(Id < NUM_MEALS);
+
+  bitSet(_DirtyMeals, Id);
+}
+
+
+/*
+ *   Returns whether there are changed meals not saved to EEPROM yet.
+ */
+bool Feeds::isDirty() const
 {
-  _Meals[Id].saveEeprom();
+  return _DirtyMeals;
+}
+
+
+/*
+ *   Saves to EEPROM one of the meals changed since they were saved. It is
+ *  done one at a time to bound the time taken: about 3.3 ms per byte that
+ *  actually changes.
+ *  Returns: true iff there are more changed meals to save.
+ */
+bool Feeds::flushMeal()
+{
+  for (uint8_t Id=0; Id<NUM_MEALS; Id++)
+    if (bitRead(_DirtyMeals, Id))
+    {
+      _Meals[Id].saveEeprom();
+      bitClear(_DirtyMeals, Id);
+      break;
+    }
+
+  return _DirtyMeals;
 }
 
 
@@ -279,6 +313,141 @@ void Feeds::_updateNext(const DateTime &Now)
     // Casting needed because DateTime::operator+ is incorrectly declared
     // without const
     NextMealTime = (DateTime &) Now + NextMealSpan;
+    // Meals are at whole minutes, whatever the seconds of Now
+    _NextMealTime = NextMealTime.unixtime() - NextMealTime.second();
     _NextMealDotw = NextMealTime.dayOfTheWeek();
   }
 }
+
+
+/*
+ *   Initializes the EEPROM with the default meals and an empty state ring.
+ *  The header is written last: if interrupted, it is done again.
+ */
+void Feeds::_format()
+{
+  for (uint8_t Id=0; Id<NUM_MEALS; Id++)
+  {
+    _Meals[Id].reset();
+    _Meals[Id].saveEeprom();
+  }
+  _State.format();
+
+  _writeHeader();
+}
+
+
+/*
+ *   Reads the meals from EEPROM, checking each one: corrupt ones and those
+ *  not stored, when NUM_MEALS has grown, are reset to the default values
+ *  and saved. The header is updated if the number of meals changed.
+ *  Parameters:
+ *  * Count: number of meals in the EEPROM.
+ */
+void Feeds::_loadMeals(uint8_t Count)
+{
+  for (uint8_t Id=0; Id<NUM_MEALS; Id++)
+    if (Id >= Count || _Meals[Id].loadEeprom())
+    {
+      _Meals[Id].reset();
+      _Meals[Id].saveEeprom();
+    }
+
+  if (Count != NUM_MEALS)
+    _writeHeader();
+}
+
+
+/*
+ *   Migrates the EEPROM from the version 0 layout: meals are read from their
+ *  old addresses, the ones out of range reset, and saved with the current
+ *  layout. The state ring did not exist in version 0, so its area is
+ *  formatted. The old magic number is cleared last, once the new header is
+ *  written: if interrupted, the migration is done again from the old data,
+ *  which is not overwritten.
+ */
+void Feeds::_migrateV0()
+{
+  for (uint8_t Id=0; Id<NUM_MEALS; Id++)
+  {
+    if (_Meals[Id].loadEepromV0(_BASE_ADDR_V0 + Id * _MEAL_SIZE_V0))
+      _Meals[Id].reset();
+    _Meals[Id].saveEeprom();
+  }
+  _State.format();
+
+  _writeHeader();
+  EEPROM.write(_MAGIC_ADDR_V0, (uint8_t) ~_MAGIC_NUMBER_V0);
+}
+
+
+/*
+ *   Writes the header of the current layout, for NUM_MEALS meals.
+ */
+void Feeds::_writeHeader() const
+{
+  Header_t Header;
+
+  Header.Magic = _MAGIC_NUMBER;
+  Header.Version = _VERSION;
+  Header.Count = NUM_MEALS;
+  Header.Crc = CrcUtil::crc16(&Header, offsetof(Header_t, Crc));
+  EEPROM.put(_HEADER_ADDR, Header);
+}
+
+
+/*
+ *   Checks the magic number and CRC of a header.
+ *  Parameters:
+ *  * Header: header read from EEPROM.
+ *  Returns: true iff it is a valid header, of any version.
+ */
+bool Feeds::_isValid(const Header_t &Header)
+{
+  return Header.Magic == _MAGIC_NUMBER &&
+    Header.Crc == CrcUtil::crc16(&Header, offsetof(Header_t, Crc));
+}
+
+
+/*
+ *   Sets whether to skip the next meal, saving it in the state ring when it
+ *  changes from the saved value.
+ *  Parameters:
+ *  * Skip: whether to skip _NextMealId.
+ */
+void Feeds::_setSkip(bool Skip)
+{
+  State_t State;
+
+  _SkipNextMeal = Skip;
+
+  if (Skip != _SkipSaved)
+  {
+    State.SkipMealId = Skip? _NextMealId: _ID_NULL;
+    State.SkipMealDotw = _NextMealDotw;
+    _State.write(&State);
+    _SkipSaved = Skip;
+  }
+}
+
+
+/*
+ *   Restores the skip of the next meal from the state ring, if it was saved
+ *  for the current next meal. A saved skip of any other meal is dropped:
+ *  that meal passed while the power was off.
+ */
+void Feeds::_loadSkip()
+{
+  State_t State;
+
+  _SkipNextMeal = false;
+  _SkipSaved = false;
+
+  if (!_State.read(&State) && State.SkipMealId != _ID_NULL)
+  {
+    // Saved as skipping, whether it is still valid or not
+    _SkipSaved = true;
+    _setSkip(_NextMealId != _ID_NULL && State.SkipMealId == _NextMealId &&
+      State.SkipMealDotw == _NextMealDotw);
+  }
+}
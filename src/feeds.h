@@ -6,14 +6,18 @@
 #include <RTClib.h>
 #include "config.h"
 #include "meal.h"
+#include "eepring.h"
 
 
 /*
  *   Class to manage feed times and related events. All times used by this
  *  this class must be homogeneous: using official times.
- *   This class stores a magic record identifier to validate that data in the
- *  EEPROM is valid. If the record does not match, it will overwrite the
- *  EEPROM with default values.
+ *   The meals are stored in the EEPROM after a header with a magic number,
+ *  the layout version and the number of meals, protected by a CRC. Each meal
+ *  has its own CRC, so a corrupt one is reset alone. An invalid header
+ *  resets them all, while older layouts are migrated in place.
+ *   The skip state of the next meal is persisted in a wear-leveled ring, as
+ *  it changes far more often than the meals, so it survives a reboot.
  */
 class Feeds
 {
@@ -36,21 +40,65 @@ public:
   bool isSkippingNext() const;
   Next_t timeOfNext(uint8_t *pDotw, uint8_t *pHour, uint8_t *pMinute) const;
   Meal *getMeal(uint8_t Id);
-  void saveMeal(uint8_t Id);
+  void setMealDirty(uint8_t Id);
+  bool isDirty() const;
+  bool flushMeal();
 
 protected:
   static const uint8_t _ID_NULL = UINT8_MAX;
-  static const uint8_t _MAGIC_NUMBER = 0b11100010;
-  static const int _MAGIC_ADDR = 0;
-  static const int _BASE_ADDR = 1;
+
+  static_assert(NUM_MEALS <= 16U, "_DirtyMeals has a bit per meal");
+
+  // EEPROM layout. The header and meals do not overlap those of version 0,
+  // so a migration interrupted by a reset is just repeated
+  static const uint8_t _VERSION = 1U;
+  static const uint8_t _MAGIC_NUMBER = 0xCFU;
+  static const int _HEADER_ADDR = 61;
+  static const int _BASE_ADDR = 67;        // First meal, Meal::EEPROM_SIZE each
+  static const int _STATE_ADDR = 128;      // EEPROM area of the state ring
+  static const uint16_t _STATE_SIZE = 128U;
+
+  // Version 0 layout: magic number and meals without CRC at the stride of
+  // sizeof (Meal) on AVR, data and EEPROM address
+  static const uint8_t _MAGIC_NUMBER_V0 = 0b11100010;
+  static const int _MAGIC_ADDR_V0 = 0;
+  static const int _BASE_ADDR_V0 = 1;
+  static const uint8_t _MEAL_SIZE_V0 = 6U;
+
+  // EEPROM header
+  struct Header_t
+  {
+    uint8_t Magic;    // _MAGIC_NUMBER
+    uint8_t Version;  // Layout version
+    uint8_t Count;    // Number of meals stored
+    uint16_t Crc;     // CRC-16 of the fields above
+  };
+
+  // Persistent state, in the ring
+  struct State_t
+  {
+    uint8_t SkipMealId;    // Meal being skipped, _ID_NULL if none
+    uint8_t SkipMealDotw;  // Day of the week of the meal being skipped
+  };
 
   Meal _Meals[NUM_MEALS];
   uint8_t _NextMealId;    // Id if the next programmed meal
   uint8_t _NextMealDotw;  // Day of the week for the If Meal
+  uint32_t _NextMealTime; // Official time of the next meal, unixtime() format
   bool _NextMealDealt;    // Whether _NextMealId has already been fed/skipped
   bool _SkipNextMeal;     // Whether to skip the next meal
+  bool _SkipSaved;        // _SkipNextMeal value saved in _State
+  uint16_t _DirtyMeals;   // Bit per meal changed and not saved to EEPROM
+  EepRing _State;         // Persistent state
 
   void _updateNext(const DateTime &Now);
+  void _format();
+  void _loadMeals(uint8_t Count);
+  void _migrateV0();
+  void _writeHeader() const;
+  static bool _isValid(const Header_t &Header);
+  void _setSkip(bool Skip);
+  void _loadSkip();
 };
 
 #endif  // _FEEDS_H_
\ No newline at end of file
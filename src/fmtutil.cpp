@@ -0,0 +1,88 @@
+#include "config.h"
+#include "fmtutil.h"
+
+
+/********************/
+/* Static constants */
+/********************/
+
+// Pairs of digits for the numbers [0,99], two chars each without terminators
+const char FmtUtil::_DIGITS2[] PROGMEM =
+  "0001020304050607080910111213141516171819"
+  "2021222324252627282930313233343536373839"
+  "4041424344454647484950515253545556575859"
+  "6061626364656667686970717273747576777879"
+  "8081828384858687888990919293949596979899";
+
+
+/***********/
+/* Methods */
+/***********/
+
+/*
+ *   Writes an unsigned number zero padded to a fixed width. When the number
+ *  does not fit in Width digits, only the least significant ones are written.
+ *  Parameters:
+ *  * pDst: buffer where to write at least Width+1 chars (with the terminator).
+ *  * Value: number to write.
+ *  * Width: number of digits to write.
+ *  Returns: pointer to the string terminator written after the digits.
+ */
+char *FmtUtil::uint(char *pDst, uint16_t Value, uint8_t Width)
+{
+  char *pEnd = pDst + Width;
+
+  // Fill from the least significant digit, two digits per iteration. Not
+  // with dec2(), its terminator would overwrite the pair written before
+  *pEnd = '\0';
+  pDst = pEnd;
+  for (; Width >= 2U; Width -= 2U)
+  {
+    const char *pDigits = _DIGITS2 + 2U*(Value % 100U);
+
+    *--pDst = pgm_read_byte(pDigits + 1);
+    *--pDst = pgm_read_byte(pDigits);
+    Value /= 100U;
+  }
+
+  // Odd width: one more digit left
+  if (Width)
+    *--pDst = '0' + Value % 10U;
+
+  return pEnd;
+}
+
+
+/*
+ *   Writes a time in HH:MM format.
+ *  Parameters:
+ *  * pDst: buffer where to write at least 6 chars (with the terminator).
+ *  * Hour: hour in range [0,23].
+ *  * Minute: minute in range [0,59].
+ *  Returns: pointer to the string terminator written after the time.
+ */
+char *FmtUtil::time(char *pDst, uint8_t Hour, uint8_t Minute)
+{
+  pDst = dec2(pDst, Hour);
+  *pDst++ = ':';
+  return dec2(pDst, Minute);
+}
+
+
+/*
+ *   Writes a date in DD/MM/YY format.
+ *  Parameters:
+ *  * pDst: buffer where to write at least 9 chars (with the terminator).
+ *  * Day: day of the month in range [1,31].
+ *  * Month: month in range [1,12].
+ *  * Year: last two digits of the year, range [0,99].
+ *  Returns: pointer to the string terminator written after the date.
+ */
+char *FmtUtil::date(char *pDst, uint8_t Day, uint8_t Month, uint8_t Year)
+{
+  pDst = dec2(pDst, Day);
+  *pDst++ = '/';
+  pDst = dec2(pDst, Month);
+  *pDst++ = '/';
+  return dec2(pDst, Year);
+}
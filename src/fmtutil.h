@@ -0,0 +1,52 @@
+#ifndef _FMTUTIL_H_
+#define _FMTUTIL_H_
+
+#include "config.h"
+#include <Arduino.h>
+
+
+/*
+ *   Static class to format numbers into text for the display without the
+ *  sprintf() machinery. All the methods write zero padded fixed width fields
+ *  with a string terminator after them, and return a pointer to that
+ *  terminator so calls can be chained to build a line.
+ */
+class FmtUtil
+{
+public:
+  // Methods
+  static char *uint(char *pDst, uint16_t Value, uint8_t Width);
+  static inline char *dec2(char *pDst, uint8_t Value);
+  static char *time(char *pDst, uint8_t Hour, uint8_t Minute);
+  static char *date(char *pDst, uint8_t Day, uint8_t Month, uint8_t Year);
+
+protected:
+  // Two character representation of the numbers [0,99]
+  static const char _DIGITS2[] PROGMEM;
+};
+
+
+/******************/
+/* Inline methods */
+/******************/
+
+/*
+ *   Writes a number as two digits, zero padded.
+ *  Parameters:
+ *  * pDst: buffer where to write at least 3 chars (with the terminator).
+ *  * Value: number in range [0,99].
+ *  Returns: pointer to the string terminator written after the digits.
+ */
+inline char *FmtUtil::dec2(char *pDst, uint8_t Value)
+{
+  const char *pDigits = _DIGITS2 + 2U*Value;
+
+  *pDst++ = pgm_read_byte(pDigits);
+  *pDst++ = pgm_read_byte(pDigits + 1);
+  *pDst = '\0';
+
+  return pDst;
+}
+
+
+#endif  // _FMTUTIL_H_
@@ -3,6 +3,7 @@
 #include <EEPROM.h>
 #include "meal.h"
 #include "dotwutil.h"
+#include "crcutil.h"
 
 
 /***********/
@@ -20,6 +21,9 @@
 Meal::Meal(uint8_t Hour, uint8_t Minute, int EepromAddress):
   _EepromAddress(EepromAddress)
 {
+  static_assert(sizeof (Meal_t) + sizeof (uint16_t) == EEPROM_SIZE,
+    "EEPROM_SIZE does not match the record");
+
   _Meal.Hour = Hour;
   _Meal.Minute = Minute;
   _Meal.Dotw = 0x00;
@@ -38,6 +42,19 @@ void Meal::setEepromAddress(int EepromAddress)
 }
 
 
+/*
+ *   Restores the default values: default time and disabled. The EEPROM
+ *  address is kept.
+ */
+void Meal::reset()
+{
+  _Meal.Hour = DEFAULT_HOUR;
+  _Meal.Minute = DEFAULT_MINUTE;
+  _Meal.Dotw = 0x00;
+  _Meal.Quantity = 0U;
+}
+
+
 /*
  *   Sets time (hour & minute) for this object meal.
  *  Parameters:
@@ -203,7 +220,8 @@ bool Meal::compare(const Meal &OtherMeal, const DateTime &TimeRef,
 
 /*
  *   Calculates the time from the reference time and day of the week to the
- *  next occurrence of this meal.
+ *  next occurrence of this meal, strictly later: one week when the meal is at
+ *  the very reference time.
  *   The result is undefined if this meal has no day of the week enabled.
  *  Parameters:
  *  * RefDotw: day of the week of the reference time.
@@ -246,33 +264,18 @@ TimeSpan Meal::timeDifference(uint8_t RefDotw, uint8_t RefHour,
     // Avoid negative overflow, delay meal a week
     MealDotw += DotwUtil::DAYS_IN_A_WEEK;
   Days = MealDotw - RefDotw;
-    
-  return TimeSpan(Days, Hours, Minutes, 0U);
-}
 
+  // Same day of the week and time as the reference: one week later
+  if (!Days && !Hours && !Minutes)
+    Days = DotwUtil::DAYS_IN_A_WEEK;
 
-/*
- *   Checks whether this Meal programmed time and days of the week match
- *  a reference Time.
- *  Parameters:
- *  * Time: reference time for the comparison.
- *  Returns:
- *  * true: iff the Meal is enabled for the day of the week, hour
- *  and minute of Time.
- *  * false: otherwise
- */
-bool Meal::matchesTime(const DateTime &Time) const
-{
-  return
-    Time.hour() == _Meal.Hour &&
-    Time.minute() == _Meal.Minute &&
-    bitRead(_Meal.Dotw, Time.dayOfTheWeek());
+  return TimeSpan(Days, Hours, Minutes, 0U);
 }
 
 
 /*
  *   Saves current object into Arduino EEPROM memory at the address assigned
- *  to this object.
+ *  to this object, followed by its CRC. Unchanged bytes are not rewritten.
  *   Return: true iff the address has not been initialized or is not valid.
  */
 bool Meal::saveEeprom() const
@@ -283,6 +286,8 @@ bool Meal::saveEeprom() const
 
   // Save meal data into Arduino EEPROM
   EEPROM.put(_EepromAddress, _Meal);
+  EEPROM.put(_EepromAddress + sizeof _Meal,
+    CrcUtil::crc16(&_Meal, sizeof _Meal));
 
   return false;
 }
@@ -290,22 +295,64 @@ bool Meal::saveEeprom() const
 
 /*
  *   Reads current object from Arduino EEPROM memory at the address assigned
- *  to this object.
- *   Return: true iff the address has not been initialized or is not valid.
+ *  to this object, checking its CRC. The object is not modified on errors.
+ *   Return: true iff the address has not been initialized or is not valid,
+ *  or the record is corrupt.
  */
 bool Meal::loadEeprom()
 {
+  Meal_t Data;
+  uint16_t Crc;
+
   // Check that we have a valid EEPROM address
   if (_EepromAddress < 0)
     return true;
 
   // Read meal data from Arduino EEPROM
-  EEPROM.get(_EepromAddress, _Meal);
+  EEPROM.get(_EepromAddress, Data);
+  EEPROM.get(_EepromAddress + sizeof Data, Crc);
+  if (Crc != CrcUtil::crc16(&Data, sizeof Data))
+    return true;
 
+  _Meal = Data;
   return false;
 }
 
 
+/*
+ *   Reads current object from a record of the version 0 EEPROM layout, the
+ *  meal data without CRC, checking its values are in range. The object is
+ *  not modified on errors.
+ *  Parameters:
+ *  * EepromAddress: address of the version 0 record.
+ *   Return: true iff the record has values out of range.
+ */
+bool Meal::loadEepromV0(int EepromAddress)
+{
+  Meal_t Data;
+
+  EEPROM.get(EepromAddress, Data);
+  if (!_isValid(Data))
+    return true;
+
+  _Meal = Data;
+  return false;
+}
+
+
+/*
+ *   Checks whether meal data has its values in range.
+ *  Parameters:
+ *  * Data: meal data to check.
+ *  Returns: true iff all the values are in range.
+ */
+bool Meal::_isValid(const Meal_t &Data)
+{
+  return Data.Hour < _HOURS_IN_A_DAY && Data.Minute < _MINUTES_IN_AN_HOUR &&
+    Data.Dotw < _BV(DotwUtil::DAYS_IN_A_WEEK) && Data.Quantity <= MAX_QUANTITY;
+}
+
+
 /*
  *   Finds the day of the week for the next occurrence of this meal
  *  after (but not equal) the reference time and day of the week.
@@ -16,10 +16,12 @@ public:
   static const uint8_t MAX_QUANTITY = 9U;
   static const uint8_t DEFAULT_HOUR = 8U;
   static const uint8_t DEFAULT_MINUTE = 0U;
+  static const uint8_t EEPROM_SIZE = 6U;  // EEPROM record: data & CRC-16
 
   Meal(uint8_t Hour = DEFAULT_HOUR, uint8_t Minute = DEFAULT_MINUTE,
     int EepromAddress = EEPROM_ADDR_NULL);
   void setEepromAddress(int EepromAddress);
+  void reset();
   void setTime(uint8_t Hour, uint8_t Minute);
   void setDotw(const bool pDotwArray[]);
   void setQuantity(uint8_t Quantity);
@@ -31,9 +33,9 @@ public:
     const;
   TimeSpan timeDifference(uint8_t RefDotw, uint8_t RefHour,
     uint8_t RefMinute) const;
-  bool matchesTime(const DateTime &Time) const;
   bool saveEeprom() const;
   bool loadEeprom();
+  bool loadEepromV0(int EepromAddress);
 
 protected:
   static const uint8_t _HOURS_IN_A_DAY = 24U;
@@ -50,6 +52,8 @@ protected:
   Meal_t _Meal;
   int _EepromAddress;  // Arduino EEPROM memory address assigned to this object
 
+  static bool _isValid(const Meal_t &Data);
+
   uint8_t _nextOccurrenceDotw(uint8_t RefDotw, uint8_t RefHour,
     uint8_t RefMinute) const;
 };
@@ -0,0 +1,157 @@
+#include "config.h"
+#include "memdiag.h"
+
+
+/******************/
+/* Linker symbols */
+/******************/
+
+extern uint8_t __data_start;  // Start of .data
+extern uint8_t __data_end;    // End of .data
+extern uint8_t __bss_start;   // Start of .bss
+extern uint8_t __bss_end;     // End of .bss
+extern uint8_t __heap_start;  // Start of the heap, after .bss
+extern char *__brkval;        // End of the heap, 0 while malloc() unused
+
+
+/****************/
+/* Friend stuff */
+/****************/
+
+// Text of a macro value, to use it in assembler
+#define _MEMDIAG_STR(X) #X
+#define _MEMDIAG_XSTR(X) _MEMDIAG_STR(X)
+
+/*
+ *   Paints the whole free RAM above the static data with the canary byte.
+ *  Placed in the .init1 section, it runs inline at reset before the C
+ *  runtime clears r1 (__zero_reg__) and sets the stack pointer, so nothing
+ *  is in the stack yet and it is all free. Hence it is naked and written in
+ *  assembler: compiled code could use r1 as zero or the stack. It only uses
+ *  r24, r25 and Z, free at that point, and makes no calls.
+ */
+void _memDiagPaint()
+{
+  static_assert(MemDiag::_CANARY == 0xC5U, "Update the canary below");
+
+  asm volatile (
+    "  ldi r30, lo8(__heap_start)\n"
+    "  ldi r31, hi8(__heap_start)\n"
+    "  ldi r24, 0xC5\n"
+    "  ldi r25, hi8(" _MEMDIAG_XSTR(RAMEND) " + 1)\n"
+    "1:\n"
+    "  st Z+, r24\n"
+    "  cpi r30, lo8(" _MEMDIAG_XSTR(RAMEND) " + 1)\n"
+    "  cpc r31, r25\n"
+    "  brne 1b\n"
+  );
+}
+
+
+/***********/
+/* Methods */
+/***********/
+
+/*
+ *   Returns the size of the .data section: initialized static data.
+ */
+uint16_t MemDiag::dataSize()
+{
+  return &__data_end - &__data_start;
+}
+
+
+/*
+ *   Returns the size of the .bss section: zeroed static data.
+ */
+uint16_t MemDiag::bssSize()
+{
+  return &__bss_end - &__bss_start;
+}
+
+
+/*
+ *   Returns the deepest stack use since reset, looking for the lowest byte
+ *  above the heap that is no longer painted.
+ */
+uint16_t MemDiag::stackMax()
+{
+  return RAMEND + 1U - (uint16_t) _heapEnd() - freeMin();
+}
+
+
+/*
+ *   Returns the current gap between the end of the heap and the stack.
+ */
+uint16_t MemDiag::freeNow()
+{
+  return SP - (uint16_t) _heapEnd();
+}
+
+
+/*
+ *   Returns the part of the gap between heap and stack that has never been
+ *  used: the canary bytes still intact from the end of the heap upwards.
+ */
+uint16_t MemDiag::freeMin()
+{
+  const uint8_t *pByte = _heapEnd();
+  uint16_t Free = 0U;
+
+  // The stack pointer is the limit: below it there are no stack frames
+  while ((uint16_t) pByte < SP && *pByte++ == _CANARY)
+    Free++;
+
+  return Free;
+}
+
+
+/*
+ *   Fills all the memory figures.
+ *  Parameters:
+ *  * pReport: where to store them.
+ */
+void MemDiag::report(Report_t *pReport)
+{
+  pReport->DataSize = dataSize();
+  pReport->BssSize = bssSize();
+  pReport->FreeMin = freeMin();
+  pReport->StackMax =
+    RAMEND + 1U - (uint16_t) _heapEnd() - pReport->FreeMin;
+  pReport->FreeNow = freeNow();
+}
+
+
+#ifdef ENABLE_DIAG_SERIAL
+/*
+ *   Prints all the memory figures in a line.
+ *  Parameters:
+ *  * Out: stream where to print them, like Serial.
+ */
+void MemDiag::print(Print &Out)
+{
+  Report_t Rep;
+
+  report(&Rep);
+  Out.print(F("data="));
+  Out.print(Rep.DataSize);
+  Out.print(F(" bss="));
+  Out.print(Rep.BssSize);
+  Out.print(F(" stackmax="));
+  Out.print(Rep.StackMax);
+  Out.print(F(" freenow="));
+  Out.print(Rep.FreeNow);
+  Out.print(F(" freemin="));
+  Out.println(Rep.FreeMin);
+}
+#endif  // ENABLE_DIAG_SERIAL
+
+
+/*
+ *   Returns the first byte after the heap, or after the static data if
+ *  malloc() has not been used.
+ */
+uint8_t *MemDiag::_heapEnd()
+{
+  return __brkval? (uint8_t *) __brkval: &__heap_start;
+}
@@ -0,0 +1,60 @@
+#ifndef _MEMDIAG_H_
+#define _MEMDIAG_H_
+
+#include "config.h"
+#include <Arduino.h>
+
+
+// Stack painting at reset, before the C runtime initialization. Global so it
+// can be placed in the .init1 section
+void _memDiagPaint() __attribute__((naked, used, section(".init1")));
+
+
+/*
+ *   Static class reporting the use of the 2KB of SRAM. Before the C runtime
+ *  initializes anything, the whole free memory between the static data and
+ *  the top of the RAM is painted with a canary byte. The stack grows down
+ *  over it, so the canary bytes still intact above the heap tell how deep
+ *  the stack has ever been.
+ *   The figures are in bytes:
+ *  * .data and .bss: static data, initialized and zeroed.
+ *  * Stack maximum: deepest stack use since reset.
+ *  * Free now: gap between the heap (or the static data, without heap) and
+ *    the stack pointer.
+ *  * Free minimum: part of the gap never used by the stack. A stack byte
+ *    that happens to hold the canary value can make it a bit larger.
+ */
+class MemDiag
+{
+public:
+  // Memory figures, in bytes
+  struct Report_t
+  {
+    uint16_t DataSize;   // .data section
+    uint16_t BssSize;    // .bss section
+    uint16_t StackMax;   // Deepest stack use since reset
+    uint16_t FreeNow;    // Current gap between heap and stack
+    uint16_t FreeMin;    // Minimum gap since reset
+  };
+
+  // Methods
+  static uint16_t dataSize();
+  static uint16_t bssSize();
+  static uint16_t stackMax();
+  static uint16_t freeNow();
+  static uint16_t freeMin();
+  static void report(Report_t *pReport);
+#ifdef ENABLE_DIAG_SERIAL
+  static void print(Print &Out);
+#endif  // ENABLE_DIAG_SERIAL
+
+protected:
+  friend void _memDiagPaint();
+
+  static const uint8_t _CANARY = 0xC5U;
+
+  static uint8_t *_heapEnd();
+};
+
+
+#endif  // _MEMDIAG_H_
@@ -6,53 +6,61 @@
 #include <LiquidCrystal.h>
 #include "event.h"
 #include "action.h"
-
-
-class Page;
+#include "uimodel.h"
 
 
 /*
- *   Data structure to handle actions within the Display and Page area.
- *  Is is basically the standard Action plus a focus management Page pointer.
+ *   Base class for the display pages. Pages are not polymorphic: the Display
+ *  knows the page tree at compile time and dispatches focus(), event() and
+ *  refresh() calls directly to the page class with the focus, so no virtual
+ *  tables are needed.
+ *   Only the Page with the focus exists at a given time: the Display builds
+ *  it in place, in memory shared by all the pages, when it gets the focus.
+ *  Therefore pages refer to each other by their PageId and must not keep
+ *  any state that needs to survive a focus change.
+ *   Pages draw the data in the UiModel shared by all of them.
  */
-class PageAction
+class Page
 {
 public:
-  // Constructors
-  PageAction(): pFocusPage(nullptr), MainAction() {}
-  PageAction(Action::ActionId Id): pFocusPage(nullptr), MainAction(Id) {}
-  // PageAction(const Action &Ac): pFocusPage(nullptr), MainAction(Ac) {}
-  PageAction(Page *pPage): pFocusPage(pPage), MainAction() {}
-  PageAction(Page *pPage, const Action &A): pFocusPage(pPage), MainAction(A) {}
+  // Identifiers of the pages, so they can be built on focus changes
+  enum PageId: uint8_t
+  {
+    PgIdNone = 0U,  // No page
+    PgIdMain,
+    PgIdConfig,
+    PgIdMeal,
+    PgIdTime,
+    PgIdDiag,
+    PgIdParent      // Parent of the current page, as in the Display tree
+  };
 
-  // Copy constructor
-  PageAction(const PageAction &PgAc): pFocusPage(PgAc.pFocusPage),
-    MainAction(PgAc.MainAction) {}
+protected:
+  friend class Display;
 
-  Page *pFocusPage;  // nullprt or new focus Page
-  Action MainAction;
+  // LCD and data model shared by all the pages, set by the Display
+  static LiquidCrystal *_pLcd;
+  static const UiModel *_pModel;
 };
 
 
 /*
- *   Abstract class to handle the display pages and widgets.
+ *   Data structure to handle actions within the Display and Page area.
+ *  Is is basically the standard Action plus a focus management PageId.
  */
-class Page
+class PageAction
 {
 public:
-  // Constructor definition
-  Page(LiquidCrystal &Lcd):
-    _Lcd(Lcd)
-  {
-  }
-
-  // Abstract virtual methods
-  virtual PageAction focus() = 0;
-  virtual PageAction event(const Event &E) = 0;
+  // Constructors
+  PageAction(): FocusPage(Page::PgIdNone), MainAction(Action::AcNone) {}
+  PageAction(Action::ActionId Id): FocusPage(Page::PgIdNone), MainAction(Id) {}
+  // PageAction(const Action &Ac): FocusPage(Page::PgIdNone), MainAction(Ac) {}
+  PageAction(Page::PageId PgId): FocusPage(PgId), MainAction() {}
+  PageAction(Page::PageId PgId, const Action &A): FocusPage(PgId),
+    MainAction(A) {}
 
-protected:
-  // Member data
-  LiquidCrystal &_Lcd;
+  Page::PageId FocusPage;  // PgIdNone or new focus Page
+  Action MainAction;
 };
 
 #endif  // _PAGE_H_
@@ -1,14 +1,6 @@
 #include "config.h"
 #include "pgconfig.h"
-
-
-/********************/
-/* Member constants */
-/********************/
-
-// Text to display in the page
-const char PgConfig::_LINE0[DISPLAY_COLS+1] PROGMEM = " SALTAR  COMIDAS";
-const char PgConfig::_LINE1[DISPLAY_COLS+1] PROGMEM = " HORA    RESET  ";
+#include "uitext.h"
 
 
 /***********/
@@ -17,16 +9,9 @@ const char PgConfig::_LINE1[DISPLAY_COLS+1] PROGMEM = " HORA    RESET  ";
 
 /*
  *   Constructor.
- *  Paramters:
- *  * pParent: parent Page where to return the focus on exit
- *  * Lcd: reference to the lcd display that is being used.
  */
-PgConfig::PgConfig(Page *pParent, LiquidCrystal &Lcd):
-  Page(Lcd),
-  _pParent(pParent),
-  _Select(Lcd, true),
-  _PgMeal(this, Lcd),
-  _PgTime(this, Lcd)
+PgConfig::PgConfig():
+  _Select(true)
 {
 }
 
@@ -39,10 +24,10 @@ PgConfig::PgConfig(Page *pParent, LiquidCrystal &Lcd):
 PageAction PgConfig::PgConfig::focus()
 {
   // Draw page
-  _Lcd.setCursor(0, 0);
-  _Lcd.print((const __FlashStringHelper *) _LINE0);
-  _Lcd.setCursor(0, 1);
-  _Lcd.print((const __FlashStringHelper *) _LINE1);
+  _pLcd->setCursor(0, 0);
+  _pLcd->print((const __FlashStringHelper *) UiText::CONFIG_LINE0);
+  _pLcd->setCursor(0, 1);
+  _pLcd->print((const __FlashStringHelper *) UiText::CONFIG_LINE1);
 
   // Draw select widget
   _Select.focus();
@@ -69,16 +54,16 @@ PageAction PgConfig::event(const Event &E)
     return PageAction(Action::AcSkipMeal);
   case 1:
     // Go to config meals page
-    return PageAction(&_PgMeal);
+    return PageAction(PgIdMeal);
   case 2:
     // Go to config time page
-    return PageAction(&_PgTime);
+    return PageAction(PgIdTime);
   case 3:
     // Clear meals and reset board
     return PageAction(Action::AcReset);
   case Widget::AcBack:
     // Go back to parent page
-    return PageAction(_pParent);
+    return PageAction(PgIdParent);
   }
 
   // Default action; do nothing
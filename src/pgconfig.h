@@ -4,8 +4,6 @@
 #include "config.h"
 #include <Arduino.h>
 #include "page.h"
-#include "pgtime.h"
-#include "pgmeal.h"
 #include "wgselect.h"
 
 
@@ -16,21 +14,17 @@
 class PgConfig: public Page
 {
 public:
-  PgConfig(Page *pParent, LiquidCrystal &Lcd);
-  virtual PageAction focus();
-  virtual PageAction event(const Event &E);
+  PgConfig();
+  PageAction focus();
+  PageAction event(const Event &E);
+  void refresh() {}  // No blinking widgets: nothing to refresh
 
 protected:
   // Static constants
   static const uint8_t _NUM_OPTIONS = 4U;
-  static const char _LINE0[DISPLAY_COLS+1] PROGMEM;
-  static const char _LINE1[DISPLAY_COLS+1] PROGMEM;
 
   // Member data
-  Page *_pParent;    // Parent page
   WgSelect _Select;  // Widget in this page
-  PgMeal _PgMeal;    // Page instance for meal configuration
-  PgTime _PgTime;    // Page instance for time configuration
 };
 
 
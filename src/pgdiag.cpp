@@ -0,0 +1,91 @@
+#include "config.h"
+#include "pgdiag.h"
+#include "memdiag.h"
+#include "fmtutil.h"
+#include "uitext.h"
+
+
+/***********/
+/* Methods */
+/***********/
+
+/*
+ *   Draws the page with the current memory figures.
+ *  Returns:
+ *  * PageAction with no action to perform.
+ */
+PageAction PgDiag::focus()
+{
+  _pLcd->setCursor(0, 0);
+  _pLcd->print((const __FlashStringHelper *) UiText::DIAG_LINE0);
+  _pLcd->setCursor(0, 1);
+  _pLcd->print((const __FlashStringHelper *) UiText::DIAG_LINE1);
+  _drawValues();
+
+  return PageAction();
+}
+
+
+/*
+ *   Manage events received by page: any button goes back to the parent page.
+ *  Parameters:
+ *  * E: event data
+ *  Returns:
+ *  * PageAction with instructions on how to proceed.
+ */
+PageAction PgDiag::event(const Event &E)
+{
+#pragma GCC diagnostic push
+// Disable: warning: enumeration value Ev* & SwEv* not handled in switch
+#pragma GCC diagnostic ignored "-Wswitch"
+
+  switch (E.Id)
+  {
+  case Event::EvSwitch:
+    if (E.Switch == Event::SwEvEnterPress || E.Switch == Event::SwEvBackPress)
+      return PageAction(PgIdParent);
+    break;
+
+  case Event::EvTime:
+    // Refresh the figures once a minute
+    _drawValues();
+    break;
+  }
+
+#pragma GCC diagnostic pop
+
+  // Default: no action
+  return PageAction();
+}
+
+
+/*
+ *   Draws all the memory figures.
+ */
+void PgDiag::_drawValues() const
+{
+  MemDiag::Report_t Rep;
+
+  MemDiag::report(&Rep);
+  _drawValue(_DATA_COL, 0U, Rep.DataSize);
+  _drawValue(_BSS_COL, 0U, Rep.BssSize);
+  _drawValue(_STACK_COL, 1U, Rep.StackMax);
+  _drawValue(_FREEMIN_COL, 1U, Rep.FreeMin);
+  _drawValue(_FREENOW_COL, 1U, Rep.FreeNow);
+}
+
+
+/*
+ *   Draws a memory figure, zero padded to 4 digits.
+ *  Parameters:
+ *  * Col, Row: LCD position of the first digit.
+ *  * Value: figure in bytes, up to 9999.
+ */
+void PgDiag::_drawValue(uint8_t Col, uint8_t Row, uint16_t Value) const
+{
+  char szValue[_DIGITS + 1U];
+
+  FmtUtil::uint(szValue, Value, _DIGITS);
+  _pLcd->setCursor(Col, Row);
+  _pLcd->write(szValue);
+}
@@ -0,0 +1,39 @@
+#ifndef _PGDIAG_H_
+#define _PGDIAG_H_
+
+#include "config.h"
+#include <Arduino.h>
+#include "page.h"
+
+
+/*
+ *   Diagnostics page of the display. Shows the SRAM use: static .data and
+ *  .bss sizes, the deepest stack use since reset, the free memory never used
+ *  by the stack and the current free gap. Figures are updated every minute,
+ *  with the time.
+ */
+class PgDiag: public Page
+{
+public:
+  PgDiag() {}
+  PageAction focus();
+  PageAction event(const Event &E);
+  void refresh() {}  // No blinking widgets: nothing to refresh
+
+protected:
+  // Columns of the 4 digit figures: .data and .bss in the first row, stack
+  // maximum, minimum and current free memory in the second
+  static const uint8_t _DIGITS = 4U;
+  static const uint8_t _DATA_COL = 3U;
+  static const uint8_t _BSS_COL = 12U;
+  static const uint8_t _STACK_COL = 1U;
+  static const uint8_t _FREEMIN_COL = 7U;
+  static const uint8_t _FREENOW_COL = 12U;
+
+  // Protected methods
+  void _drawValues() const;
+  void _drawValue(uint8_t Col, uint8_t Row, uint16_t Value) const;
+};
+
+
+#endif  // _PGDIAG_H_
@@ -1,24 +1,8 @@
 #include "config.h"
 #include <assert.h>
 #include "pgmain.h"
-#include "dotwutil.h"
-
-
-/********************/
-/* Member constants */
-/********************/
-
-// Text to display in the page
-const char PgMain::_LINE0[] PROGMEM = "%02u:%02u %c %02u/%02u/%02u";
-const char PgMain::_LINE1[] PROGMEM = "SGTE %c%02u:%02u %s";
-
-// Skip condition text. 0 -> normal, 1 -> served, 2 -> skip
-const char PgMain::_STATUS_TEXT[][_NEXTMEAL_STATUS_SIZE+1U] =
-{
-  "    ",
-  "SRVD",
-  "SALT"
-};
+#include "fmtutil.h"
+#include "uitext.h"
 
 
 /***********/
@@ -27,37 +11,25 @@ const char PgMain::_STATUS_TEXT[][_NEXTMEAL_STATUS_SIZE+1U] =
 
 /*
  *   Constructor.
- *  Paramters:
- *  * Lcd: reference to the lcd display that is being used.
  */
-PgMain::PgMain(LiquidCrystal &Lcd):
-  Page(Lcd),
-  _State(StOk),
+PgMain::PgMain():
   _ManFeeding(false),
-  _PgConfig(this, Lcd)
+  _EnterPressed(false)
 {
 }
 
 
 /*
- *   Starts a series of actions and events to draw this page in the display.
- *  It first requests the time, and then the next meal time. Uses _State
- *  to track the sequence of events.
+ *   Draws this page in the display with the time and next meal in the model.
  *  Returns:
- *  * PageAction requesting the current official time or no action when
- *    the process was already unchained and not finished.
+ *  * PageAction with AcConfigEnd: the user is not in the config pages.
  */
 PageAction PgMain::focus()
 {
-  // Only makes sense at StOk
-  if (_State == StOk)
-  {
-    // Request time
-    _State = StNeedTime;
-    return PageAction(Action::AcNeedTime);
-  }
+  _drawTime();
+  _drawNextMeal();
 
-  return PageAction();
+  return PageAction(Action::AcConfigEnd);
 }
 
 
@@ -103,37 +75,30 @@ PageAction PgMain::event(const Event &E)
       return PageAction(Action::AcManualFeedStart);
 
     case Event::SwEvEnterPress:
-      // Go to config page
-      return PageAction(&_PgConfig);
+      // Wait for the release to tell a long press
+      _EnterPressed = true;
+      _EnterPressTime = millis();
+      break;
+
+    case Event::SwEvEnterRelease:
+      // Go to config page, or to memory diagnostics page after a long press.
+      // Ignore releases of presses in other pages
+      if (_EnterPressed)
+        return PageAction(millis() - _EnterPressTime >= DIAG_HOLD_MS?
+          PgIdDiag: PgIdConfig);
+      break;
     }
     // Default action for rest of switches
     break;
 
   case Event::EvTime:
-    // Draw or update the time
-    _drawTime(E.Time);
-
-    // Check if we requested it from focus()
-    if (_State == StNeedTime)
-    {
-      // Yes, advance state
-      _State = StNeedNextMeal;
-      // Now request next meal data
-      return PageAction(Action::AcNeedNextMeal);
-    }
-    // Otherwise, just return no action
+    // Update the time
+    _drawTime();
     break;
 
   case Event::EvNextMeal:
-    // Check if we requested it, unchained from focus()
-    if (_State == StNeedNextMeal)
-    {
-      // Yes, all data received, we can finish initialization
-      _State = StOk;
-    }
-    // Either requested or because update, draw it
-    _drawNextMeal(E.NextMeal);
-    // We don't need more data: no action
+    // Update the next meal
+    _drawNextMeal();
     break;
   }
 
@@ -145,60 +110,61 @@ PageAction PgMain::event(const Event &E)
 
 
 /*
- *   Draws Time in the LCD.
- *  Parameters:
- *  * Time: time to be displayed.
+ *   Draws the model official time in the LCD.
  */
-void PgMain::_drawTime(const DateTime &Time) const
+void PgMain::_drawTime() const
 {
+  const DateTime &Time = _pModel->Time;
   char Line[DISPLAY_COLS+1];  // Plus end of string
-  char Dotw;
+  char *pLine;
   uint8_t Year;
 
   // Move LCD cursor to time positon
-  _Lcd.setCursor(_TIME_COL, _TIME_ROW);
+  _pLcd->setCursor(_TIME_COL, _TIME_ROW);
 
-  // Get single char representation of the day of the week
-  Dotw = DotwUtil::DotwCharEs[Time.dayOfTheWeek()];
   // Get last 2 digits from the year
   Year = Time.year() % 100U;
 
-  // Generate line to write
-  sprintf_P(Line, _LINE0, (unsigned) Time.hour(), (unsigned) Time.minute(),
-    Dotw, (unsigned) Time.day(), (unsigned) Time.month(), (unsigned) Year);
+  // Generate line to write: "HH:MM D DD/MM/YY"
+  pLine = FmtUtil::time(Line, Time.hour(), Time.minute());
+  *pLine++ = ' ';
+  // Single char representation of the day of the week
+  *pLine++ = pgm_read_byte(UiText::DOTW_CHAR + Time.dayOfTheWeek());
+  *pLine++ = ' ';
+  FmtUtil::date(pLine, Time.day(), Time.month(), Year);
 
   assert(strlen(Line) == DISPLAY_COLS);
 
   // Write line in LCD
-  _Lcd.write(Line);
+  _pLcd->write(Line);
 }
 
 
 /*
- *   Draws information about the next meal in the LCD.
- *  Parameters:
- *  * NextMeal: time, day of the week and status about the next meal.
+ *   Draws information about the model next meal in the LCD: time, day of the
+ *  week and status.
  */
-void PgMain::_drawNextMeal(const Event::NextMeal_t &NextMeal) const
+void PgMain::_drawNextMeal() const
 {
+  const UiModel::NextMeal_t &NextMeal = _pModel->NextMeal;
   char Line[DISPLAY_COLS+1];  // Plus end of string
-  char Dotw;
-  const char *pStatus;
+  char *pLine;
 
   // Move LCD cursor to next meal position
-  _Lcd.setCursor(_NEXTMEAL_COL, _NEXTMEAL_ROW);
+  _pLcd->setCursor(_NEXTMEAL_COL, _NEXTMEAL_ROW);
 
   // Is there a next meal?
   if (NextMeal.Status >= 0)
   {
     // Yes
-    // Get single char representation of the day of the week
-    Dotw = DotwUtil::DotwCharEs[NextMeal.Dotw];
-    pStatus = _STATUS_TEXT[NextMeal.Status];
-
-    // Generate line to write
-    sprintf_P(Line, _LINE1, Dotw, (unsigned) NextMeal.Hour,
-      (unsigned) NextMeal.Minute, pStatus);
+    // Generate line to write: "SGTE DHH:MM SSSS"
+    strcpy_P(Line, UiText::NEXTMEAL_TAG);
+    pLine = Line + UiText::NEXTMEAL_TAG_SIZE;
+    // Single char representation of the day of the week
+    *pLine++ = pgm_read_byte(UiText::DOTW_CHAR + NextMeal.Dotw);
+    pLine = FmtUtil::time(pLine, NextMeal.Hour, NextMeal.Minute);
+    *pLine++ = ' ';
+    strcpy_P(pLine, UiText::NEXTMEAL_STATUS[NextMeal.Status]);
   }
   else
   {
@@ -211,6 +177,6 @@ void PgMain::_drawNextMeal(const Event::NextMeal_t &NextMeal) const
   assert(strlen(Line) == DISPLAY_COLS);
 
   // Write line in LCD
-  _Lcd.write(Line);
+  _pLcd->write(Line);
 }
 
@@ -1,15 +1,7 @@
 #include "config.h"
 #include <assert.h>
 #include "pgmeal.h"
-
-
-/********************/
-/* Member constants */
-/********************/
-
-// Static tags in the display
-const char PgMeal::_LINE0[DISPLAY_COLS+1] PROGMEM = "COMIDA#         ";
-const char PgMeal::_LINE1[DISPLAY_COLS+1] PROGMEM = "  :   CANTIDAD  ";
+#include "uitext.h"
 
 
 /***********/
@@ -18,63 +10,37 @@ const char PgMeal::_LINE1[DISPLAY_COLS+1] PROGMEM = "  :   CANTIDAD  ";
 
 /*
  *   Constructor. Initializes class and widgets.
- *  Parameters:
- *  * pParent: parent Page where to return the focus on exit
- *  * Lcd: reference to the lcd display that is being used.
  */
-PgMeal::PgMeal(Page *pParent, LiquidCrystal &Lcd):
-  Page(Lcd),
-  _State(StOk),
-  _pParent(pParent),
-  _Initialized(false),
-  _WgDotw(Lcd, _MEAL_DOTW_COL, _MEAL_ROW, _DOTW_CHAR_TRUE, _DOTW_CHAR_FALSE,
-    DotwUtil::DAYS_IN_A_WEEK),
-  _WgMeal(Lcd, _MEAL_MEAL_COL, _MEAL_ROW, _MEAL_MEAL_SIZE),
-  _WgHour(Lcd, _TIME_HOUR_COL, _TIME_ROW, _TIME_HOUR_SIZE),
-  _WgMinute(Lcd, _TIME_MINUTE_COL, _TIME_ROW, _TIME_MINUTE_SIZE),
-  _WgQuantity(Lcd, _TIME_QUANTITY_COL, _TIME_ROW, _TIME_QUANTITY_SIZE)
+PgMeal::PgMeal():
+  _WgDotw(_MEAL_DOTW_COL, _MEAL_ROW, UiText::DOTW_CHAR_ON,
+    UiText::DOTW_CHAR_OFF, DotwUtil::DAYS_IN_A_WEEK),
+  _WgMeal(_MEAL_MEAL_COL, _MEAL_ROW, _MEAL_MEAL_SIZE),
+  _WgHour(_TIME_HOUR_COL, _TIME_ROW, _TIME_HOUR_SIZE),
+  _WgMinute(_TIME_MINUTE_COL, _TIME_ROW, _TIME_MINUTE_SIZE),
+  _WgQuantity(_TIME_QUANTITY_COL, _TIME_ROW, _TIME_QUANTITY_SIZE),
+  _FocusWidget(WgMeal)
 {
-  // Array for easy management of the time widgets
-  _Widgets[WgDotw] = &_WgDotw;
-  _Widgets[WgHour] = &_WgHour;
-  _Widgets[WgMinute] = &_WgMinute;
-  _Widgets[WgQuantity] = &_WgQuantity;
-  _Widgets[WgMeal] = &_WgMeal;
-
-  // Prepare the character representations of the DOTW in ES locale
-  for (uint8_t Dotw=0U; Dotw<DotwUtil::DAYS_IN_A_WEEK; Dotw++)
-  {
-    uint8_t DotwEn = DotwUtil::add(Dotw, 1U);
-    _DOTW_CHAR_TRUE[Dotw] = toupper(DotwUtil::DotwCharEs[DotwEn]);
-    _DOTW_CHAR_FALSE[Dotw] = tolower(DotwUtil::DotwCharEs[DotwEn]);
-  }
 }
 
 
 /*
- *   Starts a series of actions and events to draw this page in the display.
- *  It first requests the first meal data. Uses _State to track the sequence of
- *  events.
+ *   Draws this page in the display with the first meal from the model.
  *  Returns:
- *  * PageAction requesting the first meal or no action when
- *    the process was already unchained and not finished.
+ *  * PageAction with no action to perform.
  */
 PageAction PgMeal::focus()
 {
-  PageAction PgAc;
+  // Draw page
+  _pLcd->setCursor(0, _MEAL_ROW);
+  _pLcd->print((const __FlashStringHelper *) UiText::MEAL_LINE0);
+  _pLcd->setCursor(0, _TIME_ROW);
+  _pLcd->print((const __FlashStringHelper *) UiText::MEAL_LINE1);
 
-  // Only makes sense at StOk
-  if (_State == StOk)
-  {
-    // Not initialized: need to draw page and set values to widgets
-    _Initialized = false;
+  // Show first meal (#0)
+  _ValMeal = 0U;
+  _init();
 
-    // Request first meal (#0)
-    _ValMeal = 0U;
-    PgAc = _makeNeedMeal(_ValMeal);
-  }
-
-  return PgAc;
+  return PageAction();
 }
 
 
@@ -103,14 +69,15 @@ PageAction PgMeal::event(const Event &E)
     MealId = _ValMeal;  // Save meal id to later check if changed
 
     // Pass event to current widget with the focus
-    switch (_Widgets[_FocusWidget]->event(E))
+    switch (_FocusWidget == WgDotw?
+      _WgDotw.event(E): _wgInt(_FocusWidget)->event(E))
     {
     case Widget::AcBack:
       // Meal or one of the time widgets?
       if (_FocusWidget == WgMeal)
       {
         // Meal: go to previous page
-        return PageAction(_pParent);
+        return PageAction(PgIdParent);
       }
       else
       {
@@ -140,30 +107,17 @@ PageAction PgMeal::event(const Event &E)
       if (MealId != _ValMeal)
       {
         assert(_FocusWidget == WgMeal);
-        assert(_State == StOk);
 
         // Remove focus from widget to stop it blinking and be able
         // to draw the new values without being interrupted
         _WgMeal.unfocus();
-        // Request selected meal id
-        return _makeNeedMeal(_ValMeal);
+        // Show selected meal id
+        _init();
       }
       // No action
       break;
     }
     break;
-
-  case Event::EvMeal:
-    // Check if we requested it from focus() or from a change in the meal widget
-    if (_State == StNeedMeal)
-    {
-      // Yes, all data received, we can finish initialization
-      _State = StOk;
-      // Initialize page and widgets
-      _init(E.pMeal);
-    }
-    // We don't need any more data -> return no action
-    break;
   }
 
 #pragma GCC diagnostic pop
@@ -174,41 +128,37 @@ PageAction PgMeal::event(const Event &E)
 
 
 /*
- *   Initializes page and widgets or just updates values if alredy initialized.
- *  Parameters:
- *  * Time: date and time in UTC to initialize values.
+ *   Passes the periodic refresh to the widget with the focus.
  */
-void PgMeal::_init(Meal *pMeal)
+void PgMeal::refresh()
+{
+  if (_FocusWidget == WgDotw)
+    _WgDotw.refresh();
+  else
+    _wgInt(_FocusWidget)->refresh();
+}
+
+
+/*
+ *   Initializes widgets with the values of the meal in _ValMeal, taken from
+ *  the model meal table, and draws them.
+ */
+void PgMeal::_init()
 {
   uint8_t Hour, Minute;
   bool DotwEn[DotwUtil::DAYS_IN_A_WEEK];
 
   // Save pointer to the meal
-  _pMeal = pMeal;
-
-  // _ValMeal value already set
+  _pMeal = _pModel->pMeals + _ValMeal;
 
   // Set meal time values
-  pMeal->getTime(&Hour, &Minute);
+  _pMeal->getTime(&Hour, &Minute);
   _ValHour = (uint16_t) Hour;
   _ValMinute = (uint16_t) Minute;
-  _ValQuantity = pMeal->getQuantity();
-  pMeal->getDotw(DotwEn);
+  _ValQuantity = _pMeal->getQuantity();
+  _pMeal->getDotw(DotwEn);
   _rearrangeDotwFromEn(_ValDotw, DotwEn);
 
-  // If the object was not initialized since focus(), draw the page
-  if (!_Initialized)
-  {
-    // Initialize the object
-    _Initialized = true;
-
-    // Draw page
-    _Lcd.setCursor(0, _MEAL_ROW);
-    _Lcd.print((const __FlashStringHelper *) _LINE0);
-    _Lcd.setCursor(0, _TIME_ROW);
-    _Lcd.print((const __FlashStringHelper *) _LINE1);
-  }
-
   // Initialize and draw widgets
   _WgMeal.init(_MIN_MEALID, _MAX_MEALID, &_ValMeal);
   _WgDotw.init(_ValDotw);
@@ -222,22 +172,39 @@ void PgMeal::_init(Meal *pMeal)
 
 
 /*
- *   Configures the class to wait for an event with meal data and prepares
- *  the PageAction object with that request to return.
+ *   Returns the integer widget matching a widget id.
  *  Parameters:
- *  * MealId: which meal we want.
- *  Returns: the need meal action request.
+ *  * WgId: identifier of any widget but WgDotw.
+ *  Returns: pointer to the widget.
  */
-PageAction PgMeal::_makeNeedMeal(uint8_t MealId)
+WgInt *PgMeal::_wgInt(WgId_t WgId)
 {
-  // Update state: waiting for meal event
-  _State = StNeedMeal;
+  WgInt *pWidget;
 
-  // Create action to request new meal data
-  PageAction PgAc(Action::AcNeedMeal);
-  PgAc.MainAction.MealId = MealId;
+#pragma GCC diagnostic push
+// Disable: warning: enumeration value 'WgDotw' not handled in switch
+#pragma GCC diagnostic ignored "-Wswitch"
 
-  return PgAc;
+  switch (WgId)
+  {
+  case WgHour:
+    pWidget = &_WgHour;
+    break;
+  case WgMinute:
+    pWidget = &_WgMinute;
+    break;
+  case WgQuantity:
+    pWidget = &_WgQuantity;
+    break;
+  default:
+    assert(WgId == WgMeal);
+    pWidget = &_WgMeal;
+    break;
+  }
+
+#pragma GCC diagnostic pop
+
+  return pWidget;
 }
 
 
@@ -293,7 +260,11 @@ void PgMeal::_focusNextTimeWidget()
   // Update widget id; turn back to 0 after the last one
   _FocusWidget =
     WgId_t((uint8_t(_FocusWidget) + uint8_t(1U)) % _NUM_WIDGETS_TIME);
-  _Widgets[_FocusWidget]->focus();
+
+  if (_FocusWidget == WgDotw)
+    _WgDotw.focus();
+  else
+    _wgInt(_FocusWidget)->focus();
 }
 
 
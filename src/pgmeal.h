@@ -17,9 +17,10 @@
 class PgMeal: public Page
 {
 public:
-  PgMeal(Page *pParent, LiquidCrystal &Lcd);
-  virtual PageAction focus();
-  virtual PageAction event(const Event &E);
+  PgMeal();
+  PageAction focus();
+  PageAction event(const Event &E);
+  void refresh();
 
 protected:
   // Type for indexing the widgets
@@ -28,13 +29,6 @@ protected:
     WgDotw=0, WgHour, WgMinute, WgQuantity, WgMeal
   };
 
-  // To keep track of the page initialization state
-  enum State_t: uint8_t
-  {
-    StOk = 0U,
-    StNeedMeal = 1U
-  };
-
   // Static constants
 
   // How many widgets a meal has (not including meal selector)
@@ -63,17 +57,9 @@ protected:
   static const uint8_t _TIME_QUANTITY_COL = 15U;
   static const uint8_t _TIME_QUANTITY_SIZE = 1U;
 
-  // Static tags in the display
-  static const char _LINE0[DISPLAY_COLS+1] PROGMEM;
-  static const char _LINE1[DISPLAY_COLS+1] PROGMEM;
-
-  // Arrays with single letter representations of indexes
-  char _DOTW_CHAR_FALSE[DotwUtil::DAYS_IN_A_WEEK];
-  char _DOTW_CHAR_TRUE[DotwUtil::DAYS_IN_A_WEEK];
-
   // Protected methods
-  void _init(Meal *pMeal);
-  PageAction _makeNeedMeal(uint8_t MealId);
+  void _init();
+  WgInt *_wgInt(WgId_t WgId);
   PageAction _makeSetMeal() const;
   void _focusMealWidget();
   void _focusTimeWidgets();
@@ -82,9 +68,6 @@ protected:
   void _rearrangeDotwFromEn(bool *pDst, const bool *pSrc) const;
 
   // Member data
-  State_t _State;     // Current initialization state
-  Page *_pParent;     // Parent page
-  bool _Initialized;  // Wether the class has been initialized
   // Widgets in this page
   WgAbool _WgDotw;
   WgInt _WgMeal;  // Meal Id widget
@@ -97,7 +80,6 @@ protected:
   uint16_t _ValMinute;
   uint16_t _ValQuantity;
   bool _ValDotw[DotwUtil::DAYS_IN_A_WEEK];
-  Widget *_Widgets[_NUM_WIDGETS_TIME+1];  // For easy management of widgets
   WgId_t _FocusWidget;  // Which widget has the focus
   Meal *_pMeal;  // The meal that we are displaying and modifying
 };
@@ -1,5 +1,6 @@
 #include "config.h"
 #include "pgtime.h"
+#include "uitext.h"
 
 
 /********************/
@@ -7,13 +8,9 @@
 /********************/
 
 // Maximum number of days per month (assumming no leap year)
-const uint8_t PgTime::_NUM_DAYS_PER_MONTH[] =
+const uint8_t PgTime::_NUM_DAYS_PER_MONTH[] PROGMEM =
   { 31U, 28U, 31U, 30U, 31U, 30U, 31U, 31U, 30U, 31U, 30U, 31U };
 
-// Static tags in the display
-const char PgTime::_LINE0[DISPLAY_COLS+1] PROGMEM = "HORA      :  :  ";
-const char PgTime::_LINE1[DISPLAY_COLS+1] PROGMEM = "UTC     /  /    ";
-
 
 /***********/
 /* Methods */
@@ -21,42 +18,30 @@ const char PgTime::_LINE1[DISPLAY_COLS+1] PROGMEM = "UTC     /  /    ";
 
 /*
  *   Constructor. Initializes class and widgets.
- *  Parameters:
- *  * pParent: parent Page where to return the focus on exit
- *  * Lcd: reference to the lcd display that is being used.
  */
-PgTime::PgTime(Page *pParent, LiquidCrystal &Lcd):
-  Page(Lcd),
-  _State(StOk),
-  _pParent(pParent),
+PgTime::PgTime():
   _Widgets{
-    WgInt(Lcd, _TIME_HOUR_COL, _TIME_ROW, _TIME_HOUR_SIZE),
-    WgInt(Lcd, _TIME_MINUTE_COL, _TIME_ROW, _TIME_MINUTE_SIZE),
-    WgInt(Lcd, _TIME_SECOND_COL, _TIME_ROW, _TIME_SECOND_SIZE),
-    WgInt(Lcd, _DATE_DAY_COL, _DATE_ROW, _DATE_DAY_SIZE),
-    WgInt(Lcd, _DATE_MONTH_COL, _DATE_ROW, _DATE_MONTH_SIZE),
-    WgInt(Lcd, _DATE_YEAR_COL, _DATE_ROW, _DATE_YEAR_SIZE)
-  }
+    WgInt(_TIME_HOUR_COL, _TIME_ROW, _TIME_HOUR_SIZE),
+    WgInt(_TIME_MINUTE_COL, _TIME_ROW, _TIME_MINUTE_SIZE),
+    WgInt(_TIME_SECOND_COL, _TIME_ROW, _TIME_SECOND_SIZE),
+    WgInt(_DATE_DAY_COL, _DATE_ROW, _DATE_DAY_SIZE),
+    WgInt(_DATE_MONTH_COL, _DATE_ROW, _DATE_MONTH_SIZE),
+    WgInt(_DATE_YEAR_COL, _DATE_ROW, _DATE_YEAR_SIZE)
+  },
+  _FocusWidget(WgHour)
 {
 }
 
 
 /*
- *   Starts a series of actions and events to draw this page in the display.
- *  It first requests the UTC time. Uses _State to track the sequence of events.
+ *   Draws this page in the display with the current UTC time from the model.
  *  Returns:
- *  * PageAction requesting the current UTC time or no action when
- *    the process was already unchained and not finished.
+ *  * PageAction with no action to perform.
  */
 PageAction PgTime::focus()
 {
-  // Only makes sense at StOk
-  if (_State == StOk)
-  {
-    // Request time
-    _State = StNeedUtc;
-    return PageAction(Action::AcNeedTimeUtc);
-  }
+  // Initialize page and widgets
+  _init(_pModel->utcNow());
 
   return PageAction();
 }
@@ -91,10 +76,11 @@ PageAction PgTime::event(const Event &E)
       {
         // Date is correct -> return it...
         Action A(Action::AcSetTimeUtc);
-        A.Time = DateTime(_Values[WgYear], _Values[WgMonth], _Values[WgDay],
-          _Values[WgHour], _Values[WgMinute], _Values[WgSecond]);
+        A.TimeUtc = DateTime(_Values[WgYear], _Values[WgMonth],
+          _Values[WgDay], _Values[WgHour], _Values[WgMinute],
+          _Values[WgSecond]).unixtime();
         // ... and go back to parent page
-        return PageAction(_pParent, A);
+        return PageAction(PgIdParent, A);
       }
       else
         // Invalid date -> focus the day widget and perform no action
@@ -107,18 +93,6 @@ PageAction PgTime::event(const Event &E)
     // case Widget::AcNone: -> no action
     }
     break;
-
-  case Event::EvTimeUtc:
-    // Check if we requested it from focus()
-    if (_State == StNeedUtc)
-    {
-      // Yes, all data received, we can finish initialization
-      _State = StOk;
-      // Initialize page and widgets
-      _init(E.Time);
-    }
-    // We don't need any more data -> return no action
-    break;
   }
 
 #pragma GCC diagnostic pop
@@ -128,6 +102,15 @@ PageAction PgTime::event(const Event &E)
 }
 
 
+/*
+ *   Passes the periodic refresh to the widget with the focus.
+ */
+void PgTime::refresh()
+{
+  _Widgets[_FocusWidget].refresh();
+}
+
+
 /*
  *   Initializes page and widgets.
  *  Parameters:
@@ -144,10 +127,10 @@ void PgTime::_init(const DateTime &Time)
   _Values[WgYear] = Time.year();
 
    // Draw page
-  _Lcd.setCursor(0, _TIME_ROW);
-  _Lcd.print((const __FlashStringHelper *) _LINE0);
-  _Lcd.setCursor(0, _DATE_ROW);
-  _Lcd.print((const __FlashStringHelper *) _LINE1);
+  _pLcd->setCursor(0, _TIME_ROW);
+  _pLcd->print((const __FlashStringHelper *) UiText::TIME_LINE0);
+  _pLcd->setCursor(0, _DATE_ROW);
+  _pLcd->print((const __FlashStringHelper *) UiText::TIME_LINE1);
 
   // Initialize & draw widgets
   _Widgets[WgHour].init(_MIN_HOUR, _MAX_HOUR, _Values+WgHour);
@@ -196,7 +179,8 @@ void PgTime::_focusWidget(WgId_t WgId)
 bool PgTime::_validDate() const
 {
   uint8_t Month = _Values[WgMonth];
-  uint8_t MaxDay = _NUM_DAYS_PER_MONTH[Month-1];  // Month is in range [1,12]
+  // Month is in range [1,12]
+  uint8_t MaxDay = pgm_read_byte(_NUM_DAYS_PER_MONTH + Month - 1U);
 
   // Special case for February on leap year
   if (Month == 2 && _leapYear(_Values[WgYear]))
@@ -13,9 +13,10 @@
 class PgTime: public Page
 {
 public:
-  PgTime(Page *pParent, LiquidCrystal &Lcd);
-  virtual PageAction focus();
-  virtual PageAction event(const Event &E);
+  PgTime();
+  PageAction focus();
+  PageAction event(const Event &E);
+  void refresh();
 
 protected:
   // Type for indexing the widgets and their values
@@ -24,13 +25,6 @@ protected:
     WgHour=0, WgMinute, WgSecond, WgDay, WgMonth, WgYear
   };
 
-  // To keep track of the page initialization state
-   enum State_t: uint8_t
-  {
-    StOk = 0U,
-    StNeedUtc = 1U
-  };
-
  // Static constants
 
   // How many widgets this page has
@@ -65,11 +59,7 @@ protected:
   static const uint8_t _DATE_MONTH_SIZE = 2U;
   static const uint8_t _DATE_YEAR_COL = 12U;
   static const uint8_t _DATE_YEAR_SIZE = 4U;
-  static const uint8_t _NUM_DAYS_PER_MONTH[];
-
-  // Static tags in the display
-  static const char _LINE0[DISPLAY_COLS+1] PROGMEM;
-  static const char _LINE1[DISPLAY_COLS+1] PROGMEM;
+  static const uint8_t _NUM_DAYS_PER_MONTH[] PROGMEM;
 
   // Protected methods
   void _init(const DateTime &Time);
@@ -79,8 +69,6 @@ protected:
   bool _leapYear(uint16_t Year) const;
 
   // Member data
-  State_t _State;                  // Current initialization state
-  Page *_pParent;                  // Parent page
   WgInt _Widgets[_NUM_WIDGETS];    // Widgets in this page
   uint16_t _Values[_NUM_WIDGETS];  // Values for the widgets
   WgId_t _FocusWidget;             // Which widget has the focus
@@ -0,0 +1,160 @@
+#include "config.h"
+#include "prof.h"
+
+#ifdef ENABLE_PROFILING
+
+
+/********************/
+/* Member constants */
+/********************/
+
+// Names of the sections when printed, indexed by SectionId
+const char Prof::_SECTION_NAME[SeNum][_NAME_SIZE] PROGMEM =
+{
+  "loop", "t1isr", "rtcread", "dspevnt", "dsprfsh", "swcheck"
+};
+
+
+/********************/
+/* Static variables */
+/********************/
+
+Prof::Stat_t Prof::_Stats[SeNum];
+unsigned long Prof::_LastLoop;
+unsigned long Prof::_BootTimes[BtNum];
+
+
+/***********/
+/* Methods */
+/***********/
+
+/*
+ *   Adds a time to the statistics of a section. Sections timed inside an
+ *  ISR only run with interrupts disabled, so no locking is needed there.
+ *  Parameters:
+ *  * Id: section timed.
+ *  * Us: time taken in us.
+ */
+void Prof::add(SectionId Id, unsigned long Us)
+{
+  Stat_t &Stat = _Stats[Id];
+
+  if (!Stat.Count || Us < Stat.Min)
+    Stat.Min = Us;
+  if (Us > Stat.Max)
+    Stat.Max = Us;
+
+  // Stop when Count saturates, so the mean stays consistent
+  if (Stat.Count != UINT16_MAX)
+  {
+    Stat.Count++;
+    Stat.Sum += Us;
+  }
+}
+
+
+/*
+ *   Records the period since the previous call as the SeLoop section.
+ */
+void Prof::loop()
+{
+  unsigned long Now = micros();
+
+  if (_LastLoop)
+    add(SeLoop, Now - _LastLoop);
+  _LastLoop = Now;
+}
+
+
+/*
+ *   Copies the statistics of a section, coherently even if it is updated
+ *  from an ISR.
+ *  Parameters:
+ *  * Id: section to read.
+ *  * pStat: where to copy its statistics.
+ */
+void Prof::get(SectionId Id, Stat_t *pStat)
+{
+  noInterrupts();
+  *pStat = _Stats[Id];
+  interrupts();
+}
+
+
+/*
+ *   Clears the statistics of all the sections.
+ */
+void Prof::reset()
+{
+  noInterrupts();
+  memset(_Stats, 0, sizeof _Stats);
+  interrupts();
+  _LastLoop = 0UL;
+}
+
+
+/*
+ *   Timestamps the end of a boot phase.
+ *  Parameters:
+ *  * Id: phase ended.
+ */
+void Prof::boot(BootPhase Id)
+{
+  _BootTimes[Id] = micros();
+}
+
+
+/*
+ *   Returns when a boot phase ended, in us since init(). 0 if not reached.
+ *  Parameters:
+ *  * Id: phase to read.
+ */
+unsigned long Prof::bootTime(BootPhase Id)
+{
+  return _BootTimes[Id];
+}
+
+
+/*
+ *   Prints the end times of all the boot phases in a line, in us.
+ *  Parameters:
+ *  * Out: stream where to print them, like Serial.
+ */
+void Prof::printBoot(Print &Out)
+{
+  Out.print(F("boot"));
+  for (uint8_t Id = 0U; Id < BtNum; Id++)
+  {
+    Out.print(' ');
+    Out.print(_BootTimes[Id]);
+  }
+  Out.println();
+}
+
+
+/*
+ *   Prints the statistics of a section in a line: name, count and minimum,
+ *  mean and maximum times in us. Short enough to fit in the serial transmit
+ *  buffer, so it does not wait for the port.
+ *  Parameters:
+ *  * Out: stream where to print them, like Serial.
+ *  * Id: section to print.
+ */
+void Prof::printSection(Print &Out, SectionId Id)
+{
+  Stat_t Stat;
+
+  get(Id, &Stat);
+  Out.print((const __FlashStringHelper *) _SECTION_NAME[Id]);
+  Out.print(F(" n="));
+  Out.print(Stat.Count);
+  Out.print(F(" min="));
+  Out.print(Stat.Min);
+  Out.print(F(" mean="));
+  Out.print(Stat.Count? Stat.Sum / Stat.Count: 0UL);
+  Out.print(F(" max="));
+  Out.println(Stat.Max);
+}
+
+
+#endif  // ENABLE_PROFILING
@@ -0,0 +1,108 @@
+#ifndef _PROF_H_
+#define _PROF_H_
+
+#include "config.h"
+#include <Arduino.h>
+
+
+/*
+ *   Optional timing instrumentation on micros(), enabled by defining
+ *  ENABLE_PROFILING in config.h. Without it, the PROF_* macros compile to
+ *  nothing and the Prof class is not built.
+ *   PROF_SECTION(Id) times from where it is placed to the end of its block.
+ *  PROF_LOOP() records the time between consecutive calls, placed at the
+ *  start of loop(). Statistics can be read at runtime with Prof::get() or
+ *  printed with Prof::printSection().
+ *  PROF_BOOT(Id) timestamps the end of a boot phase, read with
+ *  Prof::bootTime(). Boot times count from init() in the Arduino core: the
+ *  bootloader and the global constructors (LCD initialization) before it
+ *  are not included. micros() has a 4 us resolution.
+ */
+
+#ifdef ENABLE_PROFILING
+
+#define PROF_SECTION(Id) ProfSection _ProfSection(Id)
+#define PROF_LOOP() Prof::loop()
+#define PROF_BOOT(Id) Prof::boot(Id)
+
+
+class Prof
+{
+public:
+  // Timed sections
+  enum SectionId: uint8_t
+  {
+    SeLoop = 0U,      // Period between loop() calls
+    SeTimer1Isr,      // TIMER1_COMPA_vect
+    SeRtcRead,        // RTC read and conversion to official time
+    SeDisplayEvent,   // Display::event()
+    SeDisplayRefresh, // Display::refresh()
+    SeSwitchCheck,    // SwitchPnl::check()
+    SeNum
+  };
+
+  // Boot phases, timestamped when they end
+  enum BootPhase: uint8_t
+  {
+    BtSetup = 0U,     // Entry to setup()
+    BtSwitches,       // Switch panel initialization
+    BtClock,          // RTC initialization
+    BtTime,           // First RTC read
+    BtScreen,         // Main page drawn with the time
+    BtMeals,          // Meals loaded from EEPROM and next meal shown
+    BtNum
+  };
+
+  // Statistics of a section
+  struct Stat_t
+  {
+    uint16_t Count;     // Times timed, saturates
+    unsigned long Min;  // In us
+    unsigned long Max;  // In us
+    unsigned long Sum;  // In us, for the mean: Sum / Count
+  };
+
+  // Methods
+  static void add(SectionId Id, unsigned long Us);
+  static void loop();
+  static void get(SectionId Id, Stat_t *pStat);
+  static void reset();
+  static void boot(BootPhase Id);
+  static unsigned long bootTime(BootPhase Id);
+  static void printBoot(Print &Out);
+  static void printSection(Print &Out, SectionId Id);
+
+protected:
+  static const uint8_t _NAME_SIZE = 8U;  // Section names, with end of string
+  static const char _SECTION_NAME[SeNum][_NAME_SIZE] PROGMEM;
+
+  static Stat_t _Stats[SeNum];
+  static unsigned long _LastLoop;  // micros() of the last loop() call
+  static unsigned long _BootTimes[BtNum];  // micros() at the end of phases
+};
+
+
+/*
+ *   Times the rest of the block it is built in, as a section.
+ */
+class ProfSection
+{
+public:
+  ProfSection(Prof::SectionId Id): _Id(Id), _Start(micros()) {}
+  ~ProfSection() { Prof::add(_Id, micros() - _Start); }
+
+protected:
+  const Prof::SectionId _Id;
+  const unsigned long _Start;
+};
+
+#else  // ENABLE_PROFILING
+
+#define PROF_SECTION(Id)
+#define PROF_LOOP()
+#define PROF_BOOT(Id)
+
+#endif  // ENABLE_PROFILING
+
+
+#endif  // _PROF_H_
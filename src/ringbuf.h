@@ -0,0 +1,86 @@
+#ifndef _RINGBUF_H_
+#define _RINGBUF_H_
+
+#include "config.h"
+#include <Arduino.h>
+
+
+/*
+ *   Fixed size FIFO ring buffer of elements copied by value. It is not
+ *  interrupt safe: when shared with an ISR, the main loop must access it with
+ *  interrupts disabled. One slot is kept empty to tell a full buffer from an
+ *  empty one.
+ *  Template parameters:
+ *  * T: type of the elements, trivially copyable.
+ *  * SIZE: number of slots, power of 2 up to 128.
+ */
+template <typename T, uint8_t SIZE>
+class RingBuf
+{
+public:
+  RingBuf(): _Head(0U), _Tail(0U) {}
+  bool push(const T &Elem);
+  bool pop(T &Elem);
+  bool empty() const { return _Head == _Tail; }
+  bool full() const { return ((_Head + 1U) & _MASK) == _Tail; }
+
+protected:
+  static_assert(SIZE && !(SIZE & (SIZE - 1U)) && SIZE <= 128U,
+    "SIZE must be a power of 2 up to 128");
+  static const uint8_t _MASK = SIZE - 1U;
+
+  T _Buf[SIZE];
+  uint8_t _Head;  // Next slot to write
+  uint8_t _Tail;  // Next slot to read
+};
+
+
+/***********/
+/* Methods */
+/***********/
+
+/*
+ *   Adds an element at the end of the buffer.
+ *  Parameters:
+ *  * Elem: element to add.
+ *  Returns:
+ *  * true: the element was added.
+ *  * false: the buffer is full and the element was discarded.
+ */
+template <typename T, uint8_t SIZE>
+bool RingBuf<T, SIZE>::push(const T &Elem)
+{
+  uint8_t Next = (_Head + 1U) & _MASK;
+
+  if (Next == _Tail)
+    return false;
+
+  _Buf[_Head] = Elem;
+  _Head = Next;
+
+  return true;
+}
+
+
+/*
+ *   Removes the oldest element from the buffer.
+ *  Parameters:
+ *  * Elem: where to copy the element removed.
+ *  Returns:
+ *  * true: an element was removed into Elem.
+ *  * false: the buffer is empty, Elem is not modified.
+ */
+template <typename T, uint8_t SIZE>
+bool RingBuf<T, SIZE>::pop(T &Elem)
+{
+  if (_Tail == _Head)
+    return false;
+
+  Elem = _Buf[_Tail];
+  _Tail = (_Tail + 1U) & _MASK;
+
+  return true;
+}
+
+
+#endif  // _RINGBUF_H_
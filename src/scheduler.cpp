@@ -0,0 +1,125 @@
+#include "config.h"
+#include <assert.h>
+#include "scheduler.h"
+
+
+/***********/
+/* Methods */
+/***********/
+
+/*
+ *   Constructor. All the slots start empty.
+ */
+Scheduler::Scheduler():
+  _Tasks()
+{
+}
+
+
+/*
+ *   Registers a task in a slot, not scheduled yet.
+ *  Parameters:
+ *  * TaskId: slot for the task, also its priority (0 is the highest).
+ *  * pTask: function to run.
+ *  * BudgetUs: maximum time in us the task is expected to take per run.
+ */
+void Scheduler::add(uint8_t TaskId, void (*pTask)(), uint16_t BudgetUs)
+{
+  assert(TaskId < MAX_TASKS);
+
+  Task_t &Task = _Tasks[TaskId];
+
+  Task.pTask = pTask;
+  Task.BudgetUs = BudgetUs;
+  Task.Active = false;
+  Task.Overruns = 0U;
+}
+
+
+/*
+ *   Schedules a task to run once, replacing its previous schedule.
+ *  Parameters:
+ *  * TaskId: slot of the task.
+ *  * DelayMs: time to wait before running it.
+ */
+void Scheduler::runIn(uint8_t TaskId, unsigned long DelayMs)
+{
+  Task_t &Task = _Tasks[TaskId];
+
+  Task.Due = millis() + DelayMs;
+  Task.PeriodMs = 0UL;
+  Task.Active = true;
+}
+
+
+/*
+ *   Schedules a task to run periodically, replacing its previous schedule.
+ *  Parameters:
+ *  * TaskId: slot of the task.
+ *  * PeriodMs: time between runs, must not be 0.
+ *  * DelayMs: time to wait before the first run.
+ */
+void Scheduler::runEvery(uint8_t TaskId, unsigned long PeriodMs,
+  unsigned long DelayMs)
+{
+  Task_t &Task = _Tasks[TaskId];
+
+  assert(PeriodMs);
+
+  Task.Due = millis() + DelayMs;
+  Task.PeriodMs = PeriodMs;
+  Task.Active = true;
+}
+
+
+/*
+ *   Unschedules a task. It can be called from the very task.
+ *  Parameters:
+ *  * TaskId: slot of the task.
+ */
+void Scheduler::stop(uint8_t TaskId)
+{
+  _Tasks[TaskId].Active = false;
+}
+
+
+/*
+ *   Runs the highest priority task that is due, if any. The task is
+ *  rescheduled before running it, so it can change its own schedule.
+ *  Returns:
+ *  * true: a task was run.
+ *  * false: no task was due.
+ */
+bool Scheduler::run()
+{
+  unsigned long Now = millis();
+  unsigned long Start;
+
+  for (uint8_t Id = 0U; Id < MAX_TASKS; Id++)
+  {
+    Task_t &Task = _Tasks[Id];
+
+    // Counter overflow works well while delays are under 24 days
+    if (Task.Active && (long) (Now - Task.Due) >= 0L)
+    {
+      if (!Task.PeriodMs)
+        Task.Active = false;
+      else
+      {
+        // Keep the phase, but do not try to catch up after a long delay
+        Task.Due += Task.PeriodMs;
+        if ((long) (Now - Task.Due) >= 0L)
+          Task.Due = Now + Task.PeriodMs;
+      }
+
+      Start = micros();
+      (*Task.pTask)();
+      if (micros() - Start > Task.BudgetUs && Task.Overruns != UINT8_MAX)
+        Task.Overruns++;
+
+      return true;
+    }
+  }
+
+  return false;
+}
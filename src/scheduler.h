@@ -0,0 +1,64 @@
+#ifndef _SCHEDULER_H_
+#define _SCHEDULER_H_
+
+#include "config.h"
+#include <Arduino.h>
+
+
+/*
+ *   Cooperative scheduler of periodic and one-shot tasks, run from loop().
+ *  Tasks are identified by the slot they are added in, which is also their
+ *  priority: when several tasks are due, the lowest slot runs first. Every
+ *  run() call runs at most one task, to completion, so a task must return
+ *  within its time budget. Overruns are counted per task so budgets can be
+ *  checked.
+ */
+class Scheduler
+{
+public:
+  // Public constants
+  static const uint8_t MAX_TASKS = SCHED_MAX_TASKS;
+
+  // Methods
+  Scheduler();
+  void add(uint8_t TaskId, void (*pTask)(), uint16_t BudgetUs);
+  void runIn(uint8_t TaskId, unsigned long DelayMs);
+  void runEvery(uint8_t TaskId, unsigned long PeriodMs,
+    unsigned long DelayMs = 0UL);
+  void stop(uint8_t TaskId);
+  bool run();
+  inline uint8_t overruns(uint8_t TaskId) const;
+
+protected:
+  // Task slot
+  struct Task_t
+  {
+    void (*pTask)();       // Function to call, nullptr when slot not used
+    unsigned long Due;     // millis() when it has to run next
+    unsigned long PeriodMs;  // Period when periodic, 0 when one-shot
+    uint16_t BudgetUs;     // Maximum expected run time
+    bool Active;           // Whether it is scheduled
+    uint8_t Overruns;      // Times the budget was exceeded (saturates)
+  };
+
+  // Member data
+  Task_t _Tasks[MAX_TASKS];
+};
+
+
+/******************/
+/* Inline methods */
+/******************/
+
+/*
+ *   Returns how many times a task ran longer than its budget, up to 255.
+ *  Parameters:
+ *  * TaskId: slot of the task.
+ */
+inline uint8_t Scheduler::overruns(uint8_t TaskId) const
+{
+  return _Tasks[TaskId].Overruns;
+}
+
+
+#endif  // _SCHEDULER_H_
@@ -2,6 +2,54 @@
 #include <Arduino.h>
 #include "switchpnl.h"
 
+
+/****************/
+/* Friend stuff */
+/****************/
+
+// Pointer to the object the ISRs work for
+static SwitchPnl *pSwitchPnl;
+
+/*
+ *   Interrupt Service Routine for any change in the encoder pins.
+ */
+void _isrSwitchPnlSelect()
+{
+  pSwitchPnl->_readSelect();
+}
+
+
+/*
+ *   Interrupt Service Routine for any change in the button pins.
+ */
+void _isrSwitchPnlButtons()
+{
+  pSwitchPnl->_readButtons();
+}
+
+
+/*
+ *   Timer callback for a button that kept its level for its settle time.
+ */
+void _isrSwitchPnlSettled(void *pBtn)
+{
+  pSwitchPnl->_settleButton(*(SwitchPnl::Button_t *) pBtn);
+}
+
+
+/*
+ *   Pin change interrupt for port B, where the buttons are.
+ */
+ISR(PCINT0_vect)
+{
+  _isrSwitchPnlButtons();
+}
+
+
+/***************/
+/* Class stuff */
+/***************/
+
 /*
  *   Constructor: initializes member data.
  *  The button values are pulled HIGH therefore that will be considered their
@@ -16,82 +64,162 @@ SwitchPnl::SwitchPnl(uint8_t PinSelectA, uint8_t PinSelectB, uint8_t PinEnter,
     uint8_t PinBack):
   _PinSelectA(PinSelectA),
   _PinSelectB(PinSelectB),
-  _PinEnter(PinEnter),
-  _PinBack(PinBack),
   _Select(),
-  _Enter(HIGH),  // Pulled HIGH for initial state
-  _Back(HIGH)    // Pulled HIGH for initial state
+  _Buttons{
+    // Pulled HIGH for initial state
+    { PinEnter, T1BtnEnter, SWITCH_SETTLE_MS_ENTER, HIGH, false,
+      Event::SwEvEnterPress, Event::SwEvEnterRelease },
+    { PinBack, T1BtnBack, SWITCH_SETTLE_MS_BACK, HIGH, false,
+      Event::SwEvBackPress, Event::SwEvBackRelease }
+  },
+  _SelectSteps(0),
+  _DetentMs(UINT8_MAX),
+  _LastDetentTime(0UL),
+  _LastDetentUp(false)
 {
 }
 
 
 /*
- *   Configures Arduino pins for switches, pulling them up as required.
+ *   Configures Arduino pins for switches, pulling them up as required, and
+ *  enables the interrupts that read them.
  */
-void SwitchPnl::init() const
+void SwitchPnl::init()
 {
   pinMode(_PinSelectA, INPUT_PULLUP);
   pinMode(_PinSelectB, INPUT_PULLUP);
-  pinMode(_PinEnter, INPUT_PULLUP);
-  pinMode(_PinBack, INPUT_PULLUP);
+  for (uint8_t Idx = 0U; Idx < BtnNum; Idx++)
+    pinMode(_Buttons[Idx].Pin, INPUT_PULLUP);
+
+  pSwitchPnl = this;
+
+  // Encoder: external interrupts on both edges of both pins
+  attachInterrupt(digitalPinToInterrupt(_PinSelectA), _isrSwitchPnlSelect,
+    CHANGE);
+  attachInterrupt(digitalPinToInterrupt(_PinSelectB), _isrSwitchPnlSelect,
+    CHANGE);
+
+  // Buttons: pin change interrupts, both must be in the PCINT0 group
+  noInterrupts();
+  for (uint8_t Idx = 0U; Idx < BtnNum; Idx++)
+    *digitalPinToPCMSK(_Buttons[Idx].Pin) |=
+      _BV(digitalPinToPCMSKbit(_Buttons[Idx].Pin));
+  PCIFR = _BV(PCIF0);  // Clear a possible pending interrupt flag
+  PCICR |= _BV(PCIE0);
+  interrupts();
 }
 
 
 /*
- *   Reads status of switches pins and returns an Event when changes are
- *  detected. As it is needed for the switch readings to stabilize, one single
- *  read with a change will never deliver a switch change event. Therefore
- *  the LoopCnt parameter is provided to try a maximum of LoopCnt iterations
- *  before giving up and returning a no event status. The moment a switch change
- *  is positively registered, the method just returns it.
+ *   Returns the next switch event: first button presses and releases in the
+ *  order they were registered, then all the encoder detents turned since the
+ *  last call, as a single event. It does not wait: if there is none, it
+ *  returns at once.
  *  Parameters:
- *  * LoopCnt: loop a maximum of LoopCnt iterations waiting for the switch
- *    to stabilize. If 0, no reads are taken and just returns SwEvNone.
+ *  * pSteps: where to store the detents of a SwEvSelect event, positive when
+ *    clockwise. Not modified for other events.
+ *  * pDetentMs: where to store the ms between the last two detents of a
+ *    SwEvSelect event, UINT8_MAX when longer or if the last one reversed the
+ *    direction. Not modified for other events.
  *  Returns: the registered switch event if any, otherwise SwEvNone.
  */
-Event::SwitchEvent SwitchPnl::check(uint16_t LoopCnt)
+Event::SwitchEvent SwitchPnl::check(int8_t *pSteps, uint8_t *pDetentMs)
+{
+  Event::SwitchEvent SwE;
+  bool Btn;
+  int8_t Steps;
+  uint8_t DetentMs;
+
+  // Any button event? The queue is shared with the ISR
+  noInterrupts();
+  Btn = _BtnEvents.pop(SwE);
+  interrupts();
+  if (Btn)
+    return SwE;
+
+  // Any detents? Single byte read: atomic
+  if (!_SelectSteps)
+    return Event::SwEvNone;
+
+  // Take them all, the ISR must not add any between read and reset
+  noInterrupts();
+  Steps = _SelectSteps;
+  _SelectSteps = 0;
+  DetentMs = _DetentMs;
+  interrupts();
+
+  *pSteps = Steps;
+  *pDetentMs = DetentMs;
+  return Event::SwEvSelect;
+}
+
+
+/*
+ *   Reads the encoder pins and adds up the step when one is completed,
+ *  saturating if check() takes too long to take them. It also times the
+ *  step from the previous one. Called from the ISR.
+ */
+void SwitchPnl::_readSelect()
 {
-  uint8_t Val0, Val1;
   int8_t StepSelect;
+  unsigned long Now, Elapsed;
+  bool Up;
 
-  // Iterate LoopCnt times waiting for the switch event to stabilize
-  while (LoopCnt--)
+  StepSelect = _Select.update(digitalRead(_PinSelectA),
+    digitalRead(_PinSelectB));
+  if (!StepSelect)
+    return;
+
+  // Time from the previous detent, slowest when reversing
+  Now = millis();
+  Elapsed = Now - _LastDetentTime;  // Overflow works well
+  Up = StepSelect > 0;
+  _DetentMs = Up != _LastDetentUp || Elapsed > UINT8_MAX?
+    UINT8_MAX: (uint8_t) Elapsed;
+  _LastDetentTime = Now;
+  _LastDetentUp = Up;
+
+  if (!Up && _SelectSteps != INT8_MIN)
+    _SelectSteps--;
+  else if (Up && _SelectSteps != INT8_MAX)
+    _SelectSteps++;
+}
+
+
+/*
+ *   Reads the buttons and starts the settle delay of those whose level
+ *  changed, to be registered by check() once it expires. Every bounce
+ *  restarts the delay. Called from the ISR, which does not tell which pin
+ *  changed.
+ */
+void SwitchPnl::_readButtons()
+{
+  for (uint8_t Idx = 0U; Idx < BtnNum; Idx++)
   {
-    // Check Select encoder
-    Val0 = digitalRead(_PinSelectA);
-    Val1 = digitalRead(_PinSelectB);
-    StepSelect = _Select.update(Val0, Val1);
-    if (StepSelect < 0)
-      return Event::SwEvSelectCcw;
-    else if (StepSelect > 0)
-      return Event::SwEvSelectCw;
-
-#pragma GCC diagnostic push
-  // Disable: warning: enumeration value 'FLANK_NONE' not handled in switch
-#pragma GCC diagnostic ignored "-Wswitch"
-
-    // Check Enter button: falling flank is button press
-    Val0 = digitalRead(_PinEnter);
-    switch (_Enter.updateFlank(Val0))
-    {
-    case Switch::FLANK_FALLING:
-      return Event::SwEvEnterPress;
-    case Switch::FLANK_RISING:
-      return Event::SwEvEnterRelease;
-    }
+    Button_t &Btn = _Buttons[Idx];
+    bool Level = digitalRead(Btn.Pin);
 
-    // Check Back button: falling flank is button press
-    Val0 = digitalRead(_PinBack);
-    switch (_Back.updateFlank(Val0))
+    if (Level != Btn.Level)
     {
-    case Switch::FLANK_FALLING:
-      return Event::SwEvBackPress;
-    case Switch::FLANK_RISING:
-      return Event::SwEvBackRelease;
+      Btn.Level = Level;
+      timer1Start(Btn.Slot, _isrSwitchPnlSettled, &Btn, Btn.SettleMs, false);
     }
   }
+}
+
 
-#pragma GCC diagnostic pop
- 
-  return Event::SwEvNone;
-}
\ No newline at end of file
+/*
+ *   Registers the settled level of a button in the event queue, unless it
+ *  bounced back to the registered state. When the queue is full the change
+ *  is not registered, so presses and releases keep alternating. Called from
+ *  the timer ISR.
+ *  Parameters:
+ *  * Btn: button that kept its level for its settle time.
+ */
+void SwitchPnl::_settleButton(Button_t &Btn)
+{
+  // Pulled up: LOW when pressed
+  if (Btn.Level == Btn.Pressed &&
+      _BtnEvents.push(Btn.Level? Btn.EvRelease: Btn.EvPress))
+    Btn.Pressed = !Btn.Level;
+}
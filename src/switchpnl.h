@@ -4,13 +4,30 @@
 #include "config.h"
 #include <Arduino.h>
 #include <REncoder.h>
-#include <Switch.h>
 #include "event.h"
+#include "timer1.h"
+#include "ringbuf.h"
+
+
+// ISRs need to be functions of type void (*)() -> cannot be defined inside
+// class because they would be defined as type void (*<class>::)(), so make
+// them global friend functions
+void _isrSwitchPnlSelect();
+void _isrSwitchPnlButtons();
+void _isrSwitchPnlSettled(void *pBtn);
 
 
 /*
  *   Class to manage switch panel inputs to the Arduino microcontroller in
- *  Catfeeder. The 
+ *  Catfeeder. Switches are read in interrupts: encoder detents are added up
+ *  for the main loop to take them all at once with check(), while button
+ *  changes start a Timer1 settle delay and, once it expires, the Timer1 ISR
+ *  registers the press or release in a queue for check(). So no click is
+ *  lost while the main loop is busy. Detents are timed when they happen, so
+ *  the pace of a turn is known even if check() merges many of them. The
+ *  encoder quadrature decoding needs no debouncing. The encoder must be on
+ *  the external interrupt pins (2 and 3) and the buttons on port B pins (8 to
+ *  13) that share the PCINT0 pin change interrupt. Only one object can exist.
  */
 class SwitchPnl
 {
@@ -18,18 +35,49 @@ public:
   // Public methods
   SwitchPnl(uint8_t PinSelectA, uint8_t PinSelectB, uint8_t PinEnter,
     uint8_t PinBack);
-  void init() const;
-  Event::SwitchEvent check(uint16_t LoopCnt = 1);
+  void init();
+  Event::SwitchEvent check(int8_t *pSteps, uint8_t *pDetentMs);
 
 protected:
+  friend void _isrSwitchPnlSelect();
+  friend void _isrSwitchPnlButtons();
+  friend void _isrSwitchPnlSettled(void *pBtn);
+
+  // Button indexes
+  enum BtnId_t: uint8_t
+  {
+    BtnEnter = 0U, BtnBack, BtnNum
+  };
+
+  // Button debouncing status, used only by the ISRs
+  struct Button_t
+  {
+    uint8_t Pin;
+    Timer1Slot Slot;             // Timer slot for the settle delay
+    uint8_t SettleMs;            // Time to keep the level to register it
+    bool Level;                  // Last level read
+    bool Pressed;                // Registered state
+    Event::SwitchEvent EvPress;  // Event when pressed
+    Event::SwitchEvent EvRelease;  // Event when released
+  };
+
+  // Protected methods
+  void _readSelect();
+  void _readButtons();
+  void _settleButton(Button_t &Btn);
+
+  // Member data
   uint8_t _PinSelectA, _PinSelectB;  // Pins used by rotary encoder Select
-  uint8_t _PinEnter;  // Pushbutton Enter (in Select rotary encoder)
-  uint8_t _PinBack;   // Pushbutton Back
 
-  REncoder _Select;  // Manage Select encoder states and debounce
-  Switch _Enter;     // Manage Enter button debounce
-  Switch _Back;      // Manage Back button debounce
+  REncoder _Select;             // Manage Select encoder states (ISR)
+  Button_t _Buttons[BtnNum];    // Enter (in Select encoder) and Back buttons
+  // Button events registered by the ISR, not taken by check() yet
+  RingBuf<Event::SwitchEvent, SWITCH_EDGE_QUEUE_SIZE> _BtnEvents;
+  volatile int8_t _SelectSteps;  // Detents not taken by check() yet (ISR)
+  volatile uint8_t _DetentMs;    // ms between the last 2 detents (ISR)
+  unsigned long _LastDetentTime;  // millis() of the last detent (ISR)
+  bool _LastDetentUp;            // Direction of the last detent (ISR)
 };
 
 
-#endif  // _SWITCHPNL_H_
\ No newline at end of file
+#endif  // _SWITCHPNL_H_
@@ -1,70 +1,146 @@
 #include "config.h"
 #include "timer1.h"
 #include <Arduino.h>
+#include "prof.h"
 
 
 /********************/
 /* Module constants */
 /********************/
 
-//static const uint16_t _OCR = 3906U;  // Output compare register value: 4Hz
-static const uint16_t _OCR = 5208U;  // Output compare register value: 3Hz
+static const uint16_t _OCR = 249U;  // Output compare register value: 1kHz
 static const byte _TCCR_CTC_OCR1A = _BV(WGM12);  // CTC OCR1A mode for TCCR
-static const byte _TCCR_1024 = _BV(CS12) | _BV(CS10);  // 1024 divider
+static const byte _TCCR_64 = _BV(CS11) | _BV(CS10);  // 64 divider
 
-static void (*_pIsrFunction)();
+
+/*****************/
+/* Module types */
+/*****************/
+
+// Status of a slot, shared with the ISR
+struct Timer1Slot_t
+{
+  void (*pCallback)(void *);  // Function to call on expiration
+  void *pArg;                 // Argument to pass to it
+  uint16_t PeriodMs;          // Period, or delay when one-shot
+  uint16_t LeftMs;            // Time left to expiration, 0 when inactive
+  bool Periodic;              // Whether to restart on expiration
+};
+
+
+/********************/
+/* Module variables */
+/********************/
+
+static volatile Timer1Slot_t _Slots[T1NumSlots];
+static volatile uint8_t _NumActive;  // Active slots
 
 
 /********************/
 /* Module functions */
 /********************/
 
+/*
+ *   Starts the timer ticking every ms. Called with interrupts disabled.
+ */
+static void _timerOn()
+{
+  TCCR1A = 0;
+  TCNT1 = 0;
+  OCR1A = _OCR;  // 16MHz / 64 / 1kHz - 1
+  TIFR1 = _BV(OCF1A);  // Clear a possible pending interrupt flag
+  TCCR1B = _TCCR_CTC_OCR1A | _TCCR_64;  // CTC mode for OCR1A & 64 divider
+  TIMSK1 |= _BV(OCIE1A);  // Enable match interrupts on Output Compare A
+}
+
 
 /*
- *   Define actual ISR to call the function we have stored.
+ *   Stops the timer. Called with interrupts disabled.
+ */
+static void _timerOff()
+{
+  TIMSK1 &= ~_BV(OCIE1A);  // Disable timer match interrupts on OC A
+  TCCR1B = 0;  // Reset operation modes, stops the clock
+}
+
+
+/*
+ *   Define actual ISR to call the functions of the expired slots.
  */
 ISR(TIMER1_COMPA_vect)
 {
-  // Just call the function
-  (*_pIsrFunction)();
+  PROF_SECTION(Prof::SeTimer1Isr);
+
+  for (uint8_t Idx = 0U; Idx < T1NumSlots; Idx++)
+  {
+    volatile Timer1Slot_t &Slot = _Slots[Idx];
+
+    if (Slot.LeftMs && !--Slot.LeftMs)
+    {
+      // Expired: restart or deactivate before the call, which may change it
+      if (Slot.Periodic)
+        Slot.LeftMs = Slot.PeriodMs;
+      else if (!--_NumActive)
+        _timerOff();
+
+      (*Slot.pCallback)(Slot.pArg);
+    }
+  }
 }
 
 
 /*
- *   Enables interrupts and configures the module to call the provided ISR
- *  function.
+ *   Starts a slot, replacing its previous timing if active. Can be called
+ *  from an ISR.
  *  Paramters:
- *  * pIsrFunction: pointer to functionISR  to call on interrupt
+ *  * Slot: slot to start.
+ *  * pCallback: function to call from the ISR when the slot expires.
+ *  * pArg: argument for pCallback.
+ *  * PeriodMs: delay until the (first) call, not 0.
+ *  * Periodic: whether to call it every PeriodMs or just once.
  */
-void enableIsr(void (*pIsrFunction)())
+void timer1Start(Timer1Slot Slot, void (*pCallback)(void *), void *pArg,
+  uint16_t PeriodMs, bool Periodic)
 {
-  // Set new ISR function
-  _pIsrFunction = pIsrFunction;
+  uint8_t Sreg = SREG;  // Restore the interrupt flag later, as in an ISR
 
   noInterrupts();
 
-  TCCR1A = 0;
-  TCCR1B = _TCCR_CTC_OCR1A | _TCCR_1024;  // CTC mode for OCR1A & 1024 divider
-  OCR1A = _OCR;  // 16MHz / 1024 / 3Hz
-  TIMSK1 |= _BV(OCIE1A);  // Enable match interrupts on Output Compare A
+  volatile Timer1Slot_t &S = _Slots[Slot];
+
+  if (!S.LeftMs && !_NumActive++)
+    _timerOn();
+
+  S.pCallback = pCallback;
+  S.pArg = pArg;
+  S.PeriodMs = PeriodMs;
+  S.LeftMs = PeriodMs;
+  S.Periodic = Periodic;
 
-  interrupts();
+  SREG = Sreg;
 }
 
 
 /*
- *   Disables interrupts.
+ *   Stops a slot. Nothing is done if it is not active. Can be called from an
+ *  ISR.
+ *  Paramters:
+ *  * Slot: slot to stop.
  */
-void disableIsr()
+void timer1Stop(Timer1Slot Slot)
 {
+  uint8_t Sreg = SREG;  // Restore the interrupt flag later, as in an ISR
+
   noInterrupts();
 
-  TIMSK1 &= ~_BV(OCIE1A);  // Disable timer match interrupts on OC A
-  TCCR1B = 0;  // Reset operation modes
-  TIFR1 &= ~_BV(OCF1A);  // Clear a possible pending interrupt flag
+  volatile Timer1Slot_t &S = _Slots[Slot];
 
-  interrupts();
+  if (S.LeftMs)
+  {
+    S.LeftMs = 0U;
+    if (!--_NumActive)
+      _timerOff();
+  }
 
-  // Disable ISR function
-  _pIsrFunction = nullptr;
+  SREG = Sreg;
 }
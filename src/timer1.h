@@ -2,17 +2,32 @@
 #define _TIMER1_H_
 
 #include "config.h"
+#include <Arduino.h>
 
 
 /*
- *   Handles timer1 and allows switching the Interrupt
- *  Server Routine.
+ *   Timer service on Timer1 with 1 ms resolution. It runs one-shot and
+ *  periodic callbacks in its Interrupt Service Routine, one per slot, so
+ *  its users never conflict. Callbacks must be short and may start or stop
+ *  any slot, including their own. The timer only runs while a slot is
+ *  active.
  *   As ISR() macro does not work inside of a class, we need to implement
  *  this as a module.
  */
 
-void enableIsr(void (*pIsrFunction)());
-void disableIsr();
+// Timer slots, one per user
+enum Timer1Slot: uint8_t
+{
+  T1Blink = 0U,  // Blinking of the widget with the focus
+  T1BtnEnter,    // Enter button debounce
+  T1BtnBack,     // Back button debounce
+  T1Auger,       // Auger motor stepping
+  T1NumSlots
+};
+
+void timer1Start(Timer1Slot Slot, void (*pCallback)(void *), void *pArg,
+  uint16_t PeriodMs, bool Periodic);
+void timer1Stop(Timer1Slot Slot);
 
 
 #endif  // _TIMER1_H_
@@ -0,0 +1,66 @@
+#ifndef _UIMODEL_H_
+#define _UIMODEL_H_
+
+#include "config.h"
+#include <Arduino.h>
+#include <RTClib.h>
+#include "feeds.h"
+#include "meal.h"
+
+
+/*
+ *   Snapshot of the data shown by the Display pages. The main loop keeps it
+ *  current and notifies the Display with an event when something changes,
+ *  while the pages just read it when they need to draw. This way pages do
+ *  not need to request data through actions and wait for the events with it.
+ */
+class UiModel
+{
+public:
+  /**************/
+  /* Data types */
+  /**************/
+
+  // Next meal information
+  struct NextMeal_t
+  {
+    uint8_t Dotw;  // Range [0,6] being 0 Sunday (like DateTime class)
+    uint8_t Hour;
+    uint8_t Minute;
+    Feeds::Next_t Status;
+  };
+
+  // Methods
+  inline DateTime utcNow() const;
+
+
+  /***************/
+  /* Member data */
+  /***************/
+
+  DateTime Time;             // Official time, updated every minute
+  DateTime TimeUtc;          // Same time as Time, in UTC
+  unsigned long TimeMillis;  // millis() when Time was read from the RTC
+  NextMeal_t NextMeal;       // Next meal to serve
+  Meal *pMeals;              // Table with the NUM_MEALS meals
+};
+
+
+/******************/
+/* Inline methods */
+/******************/
+
+/*
+ *   Estimates current UTC time from the last snapshot, without reading the
+ *  RTC. It is accurate to about a second, as the RTC has no sub-second
+ *  resolution.
+ */
+inline DateTime UiModel::utcNow() const
+{
+  // Casting needed because DateTime::operator+ is incorrectly declared
+  // without const
+  return (DateTime &) TimeUtc + TimeSpan((millis() - TimeMillis) / 1000UL);
+}
+
+
+#endif  // _UIMODEL_H_
@@ -0,0 +1,69 @@
+#include "config.h"
+#include "uitext.h"
+
+
+/********************/
+/* Static constants */
+/********************/
+
+#if defined(LOCALE_ES)
+
+const char UiText::MSG_RESET[] PROGMEM = "REINICIALIZANDO";
+const char UiText::MSG_ERROR[] PROGMEM = "ERROR:";
+
+const char UiText::CONFIG_LINE0[DISPLAY_COLS+1] PROGMEM = " SALTAR  COMIDAS";
+const char UiText::CONFIG_LINE1[DISPLAY_COLS+1] PROGMEM = " HORA    RESET  ";
+const char UiText::MEAL_LINE0[DISPLAY_COLS+1] PROGMEM = "COMIDA#         ";
+const char UiText::MEAL_LINE1[DISPLAY_COLS+1] PROGMEM = "  :   CANTIDAD  ";
+const char UiText::TIME_LINE0[DISPLAY_COLS+1] PROGMEM = "HORA      :  :  ";
+const char UiText::TIME_LINE1[DISPLAY_COLS+1] PROGMEM = "UTC     /  /    ";
+const char UiText::DIAG_LINE0[DISPLAY_COLS+1] PROGMEM = "DAT      BSS    ";
+const char UiText::DIAG_LINE1[DISPLAY_COLS+1] PROGMEM = "P     L    /    ";
+
+const char UiText::NEXTMEAL_TAG[NEXTMEAL_TAG_SIZE+1U] PROGMEM = "SGTE ";
+const char UiText::NEXTMEAL_STATUS[][NEXTMEAL_STATUS_SIZE+1U] PROGMEM =
+{
+  "    ",
+  "SRVD",
+  "SALT"
+};
+
+const char UiText::DOTW_CHAR[DotwUtil::DAYS_IN_A_WEEK] PROGMEM =
+  { 'D', 'L', 'M', 'X', 'J', 'V', 'S' };
+const char UiText::DOTW_CHAR_ON[DotwUtil::DAYS_IN_A_WEEK] PROGMEM =
+  { 'L', 'M', 'X', 'J', 'V', 'S', 'D' };
+const char UiText::DOTW_CHAR_OFF[DotwUtil::DAYS_IN_A_WEEK] PROGMEM =
+  { 'l', 'm', 'x', 'j', 'v', 's', 'd' };
+
+#elif defined(LOCALE_EN)
+
+const char UiText::MSG_RESET[] PROGMEM = "REBOOTING";
+const char UiText::MSG_ERROR[] PROGMEM = "ERROR:";
+
+const char UiText::CONFIG_LINE0[DISPLAY_COLS+1] PROGMEM = " SKIP    MEALS  ";
+const char UiText::CONFIG_LINE1[DISPLAY_COLS+1] PROGMEM = " TIME    RESET  ";
+const char UiText::MEAL_LINE0[DISPLAY_COLS+1] PROGMEM = "MEAL  #         ";
+const char UiText::MEAL_LINE1[DISPLAY_COLS+1] PROGMEM = "  :   QUANTITY  ";
+const char UiText::TIME_LINE0[DISPLAY_COLS+1] PROGMEM = "TIME      :  :  ";
+const char UiText::TIME_LINE1[DISPLAY_COLS+1] PROGMEM = "UTC     /  /    ";
+const char UiText::DIAG_LINE0[DISPLAY_COLS+1] PROGMEM = "DAT      BSS    ";
+const char UiText::DIAG_LINE1[DISPLAY_COLS+1] PROGMEM = "S     F    /    ";
+
+const char UiText::NEXTMEAL_TAG[NEXTMEAL_TAG_SIZE+1U] PROGMEM = "NEXT ";
+const char UiText::NEXTMEAL_STATUS[][NEXTMEAL_STATUS_SIZE+1U] PROGMEM =
+{
+  "    ",
+  "SRVD",
+  "SKIP"
+};
+
+const char UiText::DOTW_CHAR[DotwUtil::DAYS_IN_A_WEEK] PROGMEM =
+  { 'U', 'M', 'T', 'W', 'H', 'F', 'S' };
+const char UiText::DOTW_CHAR_ON[DotwUtil::DAYS_IN_A_WEEK] PROGMEM =
+  { 'M', 'T', 'W', 'H', 'F', 'S', 'U' };
+const char UiText::DOTW_CHAR_OFF[DotwUtil::DAYS_IN_A_WEEK] PROGMEM =
+  { 'm', 't', 'w', 'h', 'f', 's', 'u' };
+
+#else
+#error "Define LOCALE_ES or LOCALE_EN in config.h"
+#endif
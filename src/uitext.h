@@ -0,0 +1,49 @@
+#ifndef _UITEXT_H_
+#define _UITEXT_H_
+
+#include "config.h"
+#include <Arduino.h>
+#include "dotwutil.h"
+
+
+/*
+ *   Static class with all the texts and character tables shown in the
+ *  display, stored in program memory. The language is selected at compile
+ *  time in config.h with LOCALE_ES or LOCALE_EN. Page lines keep the layout
+ *  expected by the widgets of each page in every language.
+ */
+class UiText
+{
+public:
+  // Public Constants
+  static const uint8_t NEXTMEAL_TAG_SIZE = 5U;
+  static const uint8_t NEXTMEAL_STATUS_SIZE = 4U;
+
+  // Display messages
+  static const char MSG_RESET[] PROGMEM;
+  static const char MSG_ERROR[] PROGMEM;
+
+  // Static lines of the pages
+  static const char CONFIG_LINE0[DISPLAY_COLS+1] PROGMEM;
+  static const char CONFIG_LINE1[DISPLAY_COLS+1] PROGMEM;
+  static const char MEAL_LINE0[DISPLAY_COLS+1] PROGMEM;
+  static const char MEAL_LINE1[DISPLAY_COLS+1] PROGMEM;
+  static const char TIME_LINE0[DISPLAY_COLS+1] PROGMEM;
+  static const char TIME_LINE1[DISPLAY_COLS+1] PROGMEM;
+  static const char DIAG_LINE0[DISPLAY_COLS+1] PROGMEM;
+  static const char DIAG_LINE1[DISPLAY_COLS+1] PROGMEM;
+
+  // Next meal in the main page: tag and status (normal, served, skip)
+  static const char NEXTMEAL_TAG[NEXTMEAL_TAG_SIZE+1U] PROGMEM;
+  static const char NEXTMEAL_STATUS[][NEXTMEAL_STATUS_SIZE+1U] PROGMEM;
+
+  // Single letter for each day of the week, Sunday first (like DateTime)
+  static const char DOTW_CHAR[DotwUtil::DAYS_IN_A_WEEK] PROGMEM;
+
+  // Days of the week enabled/disabled in a meal, Monday first
+  static const char DOTW_CHAR_ON[DotwUtil::DAYS_IN_A_WEEK] PROGMEM;
+  static const char DOTW_CHAR_OFF[DotwUtil::DAYS_IN_A_WEEK] PROGMEM;
+};
+
+
+#endif  // _UITEXT_H_
@@ -8,26 +8,18 @@
 /* Friend stuff */
 /***************/
 
-// Pointer to object used by _isrWgIntBlink to make it blink
-static WgAbool *pBlinkObj;
-
 /*
- *   Interrupt Service Routine to make the LCD value blink. Defined out of the
- *  class to match the void (*)() type. It will behave as belonging to object
- *  pBlinkObj.
+ *   Timer callback to make the LCD value blink, called from the timer ISR.
+ *  Defined out of the class to match the void (*)(void *) type. It will
+ *  behave as belonging to object pObj.
+ *   It only flips the blink phase: the LCD is updated from the main context
+ *  in refresh().
  */
-void _isrWgAboolBlink()
+void _isrWgAboolBlink(void *pObj)
 {
-  if (pBlinkObj->_BlinkClear)
-  {
-    pBlinkObj->_draw();
-    pBlinkObj->_BlinkClear = false;
-  }
-  else
-  {
-    pBlinkObj->_clear();
-    pBlinkObj->_BlinkClear = true;
-  }
+  WgAbool *pThis = (WgAbool *) pObj;
+
+  pThis->_BlinkClear = !pThis->_BlinkClear;
 }
 
 
@@ -39,21 +31,21 @@ void _isrWgAboolBlink()
  *   Constructor. Initializes the object. Note that _pValues is not initialized.
  *  It can change from call to call.
  *  Parameters:
- *  * Lcd: reference to the lcd display that is being used.
  *  * PosX: column where to start displaying the widget.
  *  * PosY: row where to start displaying the widget.
- *  * pCharTrue: array with char to display when the value is true
- *  * pCharFalse: array with char to display when the value is false
+ *  * pCharTrue: PROGMEM array with char to display when the value is true
+ *  * pCharFalse: PROGMEM array with char to display when the value is false
  *  * Size: size of the arrays and of the widget (number of bools)
  */
-WgAbool::WgAbool(LiquidCrystal &Lcd, uint8_t PosX, uint8_t PosY,
-    const char *pCharTrue, const char *pCharFalse, uint8_t Size):
-  Widget(Lcd),
+WgAbool::WgAbool(uint8_t PosX, uint8_t PosY, const char *pCharTrue,
+    const char *pCharFalse, uint8_t Size):
   _X(PosX),
   _Y(PosY),
   _Size(Size),
   _pCharTrue(pCharTrue),
-  _pCharFalse(pCharFalse)
+  _pCharFalse(pCharFalse),
+  _BlinkClear(false),
+  _Cleared(false)
 {
   assert(Size > 0U);
 }
@@ -87,6 +79,28 @@ void WgAbool::focus()
 }
 
 
+/*
+ *   Renders in the LCD the blink phase requested by the ISR, if it changed
+ *  since the last call. Must be called periodically from the main context.
+ */
+void WgAbool::refresh()
+{
+  // Single byte read: atomic, no need to disable interrupts
+  bool BlinkClear = _BlinkClear;
+
+  // Has the ISR flipped the phase since we last rendered it?
+  if (BlinkClear != _Cleared)
+  {
+    if (BlinkClear)
+      _clear();
+    else
+      _draw();
+
+    _Cleared = BlinkClear;
+  }
+}
+
+
 /*
  *   Process switches events.
  *  Parameters:
@@ -108,11 +122,14 @@ int8_t WgAbool::event(const Event &E)
   if (E.Id == Event::EvSwitch)
     switch (E.Switch)
     {
-    case Event::SwEvSelectCw:
-    case Event::SwEvSelectCcw:
-      // Invert value and update LCD while blinking
-      _pValues[_CurPos] = !_pValues[_CurPos];
-      _drawBlinking();
+    case Event::SwEvSelect:
+      // Each detent inverts the value: only odd counts change it. Update LCD
+      // once while blinking
+      if (E.Steps & 1)
+      {
+        _pValues[_CurPos] = !_pValues[_CurPos];
+        _drawBlinking();
+      }
       // Ac = AcNone;
       break;
     case Event::SwEvEnterPress:
@@ -151,12 +168,12 @@ void WgAbool::_drawAll() const
   uint8_t Pos;
 
   // Go to the position of the widget
-  _Lcd.setCursor(_X, _Y);
+  _pLcd->setCursor(_X, _Y);
 
   // Traverse every position in the values
   for (Pos = 0U; Pos<_Size; Pos++)
     // Write value at Pos position according to its value the Char arrays
-    _Lcd.write(_getChar(Pos));
+    _pLcd->write(_getChar(Pos));
 }
 
 
@@ -166,10 +183,10 @@ void WgAbool::_drawAll() const
 void WgAbool::_draw() const
 {
   // Move LCD cursor to the position of the value
-  _Lcd.setCursor(_X + _CurPos, _Y);
+  _pLcd->setCursor(_X + _CurPos, _Y);
 
   // Write value at _CurPos position according to its value the Char arrays
-  _Lcd.write(_getChar(_CurPos));
+  _pLcd->write(_getChar(_CurPos));
 }
 
 
@@ -179,10 +196,10 @@ void WgAbool::_draw() const
 void WgAbool::_clear() const
 {
   // Move LCD cursor to the position of the value
-  _Lcd.setCursor(_X + _CurPos, _Y);
+  _pLcd->setCursor(_X + _CurPos, _Y);
 
   // Write blank
-  _Lcd.write(' ');
+  _pLcd->write(' ');
 }
 
 
@@ -191,16 +208,10 @@ void WgAbool::_clear() const
  */
 void WgAbool::_drawBlinking() const
 {
-  // Mutex to make _BlinkClear access and _draw() atomic
-  noInterrupts();
-
   // Are we in draw period?
-  if (!_BlinkClear)
+  if (!_Cleared)
     // Yes -> draw again
     _draw();
-
-  // End mutex
-  interrupts();
 }
 
 
@@ -210,11 +221,8 @@ void WgAbool::_drawBlinking() const
  */
 void WgAbool::_nextPos()
 {
-  // Mutex to correcly draw old and new position accessing _BlinkClear
-  noInterrupts();
-
   // Are we in clear time?
-  if (_BlinkClear)
+  if (_Cleared)
   {
     // Yes -> leave old _CurPos drawn
     _draw();
@@ -226,35 +234,36 @@ void WgAbool::_nextPos()
   else
     // We are in drawn period, no need to draw or clear anything
     _CurPos++;
-
-  // End mutex
-  interrupts();
 }
 
 
 /*
- *   Enable Interrupt Service Routine to manage the blinking.
+ *   Start the timer managing the blinking.
  */
 void WgAbool::_blinkOn()
 {
   // We are currently displaying the value
   _BlinkClear = false;
+  _Cleared = false;
 
-  // Enable ISR to blinking function and reference it to this obj
-  pBlinkObj = this;
-  enableIsr(_isrWgAboolBlink);
+  // Start the blinking timer, calling back on this obj
+  timer1Start(T1Blink, _isrWgAboolBlink, this, DISPLAY_BLINK_MS, true);
 }
 
 
 /*
- *   Disable the Interrupt Service Routine managing the blinking.
+ *   Stop the timer managing the blinking.
  */
-void WgAbool::_blinkOff() const
+void WgAbool::_blinkOff()
 {
-  // Disable ISR for blinking
-  disableIsr();
+  // Stop the blinking timer
+  timer1Stop(T1Blink);
 
   // If it left in clear state, draw it
-  if (_BlinkClear)
+  if (_Cleared)
     _draw();
+
+  // Timer is stopped: safe to reset the phase
+  _BlinkClear = false;
+  _Cleared = false;
 }
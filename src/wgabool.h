@@ -6,10 +6,10 @@
 #include "widget.h"
 
 
-// ISR needs to be function of type void (*)() -> cannot be defined inside class
-// because it would be defined as type void (*<class>::)(), so make it a global
-// friend function
-void _isrWgAboolBlink();
+// Timer callback needs to be function of type void (*)(void *) -> cannot be
+// defined inside class because it would be defined as type
+// void (*<class>::)(void *), so make it a global friend function
+void _isrWgAboolBlink(void *pObj);
 
 
 /*
@@ -18,15 +18,16 @@ void _isrWgAboolBlink();
 class WgAbool: public Widget
 {
 public:
-  WgAbool(LiquidCrystal &Lcd, uint8_t PosX, uint8_t PosY, const char *pCharTrue,
+  WgAbool(uint8_t PosX, uint8_t PosY, const char *pCharTrue,
     const char *pCharFalse, uint8_t Size);
   void init(bool *pValues);
 
-  virtual void focus();
-  virtual int8_t event(const Event &E);
+  void focus();
+  void refresh();
+  int8_t event(const Event &E);
 
 protected:
-  friend void _isrWgAboolBlink();
+  friend void _isrWgAboolBlink(void *pObj);
 
   // Protected methods
   void _drawAll() const;
@@ -35,19 +36,20 @@ protected:
   void _drawBlinking() const;
   void _nextPos();
   void _blinkOn();
-  void _blinkOff() const;
+  void _blinkOff();
   inline uint8_t _getChar(uint8_t Pos) const;
 
   // Member data
   const uint8_t _X;     // Column where to display the widget
   const uint8_t _Y;     // Row where to display the widget
   const uint8_t _Size;  // Number of charaters of the widget
-  const char *_pCharTrue;
-  const char *_pCharFalse;
+  const char *_pCharTrue;   // PROGMEM chars for true values
+  const char *_pCharFalse;  // PROGMEM chars for false values
 
   bool *_pValues;      // Array of bool with current values
   uint8_t _CurPos;     // Current position in the array
-  volatile bool _BlinkClear;  // When blinking: true iif displaying blank phase
+  volatile bool _BlinkClear;  // When blinking: true iif blank phase (by ISR)
+  bool _Cleared;              // Whether the LCD is showing the blank phase
 };
 
 
@@ -59,7 +61,7 @@ protected:
  */
 inline uint8_t WgAbool::_getChar(uint8_t Pos) const
 {
-  return _pValues[Pos]? _pCharTrue[Pos]: _pCharFalse[Pos];
+  return pgm_read_byte((_pValues[Pos]? _pCharTrue: _pCharFalse) + Pos);
 }
 
 
@@ -2,32 +2,25 @@
 #include <assert.h>
 #include "wgint.h"
 #include "timer1.h"
+#include "fmtutil.h"
 
 
 /***************/
 /* Friend stuff */
 /***************/
 
-// Pointer to object used by _isrWgIntBlink to make it blink
-static WgInt *pBlinkObj;
-
 /*
- *   Interrupt Service Routine to make the LCD value blink. Defined out of the
- *  class to match the void (*)() type. It will behave as belonging to object
- *  pBlinkObj.
+ *   Timer callback to make the LCD value blink, called from the timer ISR.
+ *  Defined out of the class to match the void (*)(void *) type. It will
+ *  behave as belonging to object pObj.
+ *   It only flips the blink phase: the LCD is updated from the main context
+ *  in refresh(), keeping the ISR a few cycles long.
  */
-void _isrWgIntBlink()
+void _isrWgIntBlink(void *pObj)
 {
-  if (pBlinkObj->_BlinkClear)
-  {
-    pBlinkObj->_draw();
-    pBlinkObj->_BlinkClear = false;
-  }
-  else
-  {
-    pBlinkObj->_clear();
-    pBlinkObj->_BlinkClear = true;
-  }
+  WgInt *pThis = (WgInt *) pObj;
+
+  pThis->_BlinkClear = !pThis->_BlinkClear;
 }
 
 
@@ -35,20 +28,29 @@ void _isrWgIntBlink()
 /* Class stuff */
 /***************/
 
+// Acceleration curve, from fastest to slowest
+const WgInt::Accel_t WgInt::_ACCEL[] PROGMEM =
+{
+  { WGINT_ACCEL_FAST_MS, WGINT_ACCEL_FAST_STEP },
+  { WGINT_ACCEL_MEDIUM_MS, WGINT_ACCEL_MEDIUM_STEP }
+};
+const uint8_t WgInt::_ACCEL_SIZE = sizeof _ACCEL / sizeof *_ACCEL;
+
+
 /*
  *   Constructor. Initializes the object. Note that _MinValue and _MaxValue
  *  are not initialized. They can change from call to call.
  *  Parameters:
- *  * Lcd: reference to the lcd display that is being used.
  *  * PosX: column where to start displaying the widget.
  *  * PosY: row where to start displaying the widget.
  *  * Size: size of the arrays and of the widget (number of bools)
  */
-WgInt::WgInt(LiquidCrystal &Lcd, uint8_t PosX, uint8_t PosY, uint8_t Size):
-  Widget(Lcd),
+WgInt::WgInt(uint8_t PosX, uint8_t PosY, uint8_t Size):
   _X(PosX),
   _Y(PosY),
-  _Size(Size)
+  _Size(Size),
+  _BlinkClear(false),
+  _Cleared(false)
 {
   assert(Size > 0U);
 }
@@ -102,6 +104,28 @@ void WgInt::unfocus()
 }
 
 
+/*
+ *   Renders in the LCD the blink phase requested by the ISR, if it changed
+ *  since the last call. Must be called periodically from the main context.
+ */
+void WgInt::refresh()
+{
+  // Single byte read: atomic, no need to disable interrupts
+  bool BlinkClear = _BlinkClear;
+
+  // Has the ISR flipped the phase since we last rendered it?
+  if (BlinkClear != _Cleared)
+  {
+    if (BlinkClear)
+      _clear();
+    else
+      _draw();
+
+    _Cleared = BlinkClear;
+  }
+}
+
+
 /*
  *   Process switches events.
  *  Parameters:
@@ -123,15 +147,12 @@ int8_t WgInt::event(const Event &E)
   if (E.Id == Event::EvSwitch)
     switch (E.Switch)
     {
-    case Event::SwEvSelectCw:
-      // Decrease value option and update LCD while blinking
-      _increment();
-      _drawBlinking();
-      // Ac = AcNone;
-      break;
-    case Event::SwEvSelectCcw:
-      // Increase value option and update LCD while blinking
-      _decrement();
+    case Event::SwEvSelect:
+      // Change value by all the detents and update LCD once while blinking
+      if (E.Steps > 0)
+        _increment(_step(E.DetentMs) * (uint16_t) E.Steps);
+      else
+        _decrement(_step(E.DetentMs) * (uint16_t) -E.Steps);
       _drawBlinking();
       // Ac = AcNone;
       break;
@@ -159,19 +180,13 @@ int8_t WgInt::event(const Event &E)
 void WgInt::_draw() const
 {
   char szValue[_Size + 1];
-  char szFormat[] = "%0*u";
-
-  // Arduino sprintf does not suport field size in a paramter: do it manually
-  assert(_Size < 10U);
-  szFormat[2] = '0' + _Size;
 
   // Move cursor to widget place
-  _Lcd.setCursor(_X, _Y);
+  _pLcd->setCursor(_X, _Y);
 
-  // Convert value to text. It should fit.
-  //  sprintf(szValue, "%0*u", (int) _Size, *_pValue);
-  sprintf(szValue, szFormat, *_pValue);
-  _Lcd.write(szValue);
+  // Convert value to zero padded text. It should fit.
+  FmtUtil::uint(szValue, *_pValue, _Size);
+  _pLcd->write(szValue);
 }
 
 
@@ -183,11 +198,11 @@ void WgInt::_clear() const
   uint8_t Size = _Size;
 
   // Move cursor to widget place
-  _Lcd.setCursor(_X, _Y);
+  _pLcd->setCursor(_X, _Y);
 
   // Overwrite with blanks
   while (Size--)
-    _Lcd.write(' ');
+    _pLcd->write(' ');
 }
 
 
@@ -196,67 +211,105 @@ void WgInt::_clear() const
  */
 void WgInt::_drawBlinking() const
 {
-  // MUTEX for the interrupt protecting _BlinkClear
-  noInterrupts();
-
-  // Draw the new value only while displaying a value, not on clear
-  if (!_BlinkClear)
+  // Draw the new value only while displaying a value, not on clear. If the
+  // ISR flips the phase meanwhile, next refresh() will catch up
+  if (!_Cleared)
     _draw();
-
-  // Exit the MUTEX
-  interrupts();
 }
 
 
 /*
- *   Enable Interrupt Service Routine to manage the blinking.
+ *   Start the timer managing the blinking.
  */
 void WgInt::_blinkOn()
 {
   // We are currently displaying the value
   _BlinkClear = false;
+  _Cleared = false;
 
-  // Enable ISR to blinking function and reference it to this obj
-  pBlinkObj = this;
-  enableIsr(_isrWgIntBlink);
+  // Start the blinking timer, calling back on this obj
+  timer1Start(T1Blink, _isrWgIntBlink, this, DISPLAY_BLINK_MS, true);
 }
 
 
 /*
- *   Disable the Interrupt Service Routine managing the blinking.
+ *   Stop the timer managing the blinking.
  */
-void WgInt::_blinkOff() const
+void WgInt::_blinkOff()
 {
-  // Disable ISR for blinking
-  disableIsr();
+  // Stop the blinking timer
+  timer1Stop(T1Blink);
 
   // If it left in clear state, draw it
-  if (_BlinkClear)
+  if (_Cleared)
     _draw();
+
+  // Timer is stopped: safe to reset the phase
+  _BlinkClear = false;
+  _Cleared = false;
 }
 
 
 /*
- *   Increments current value within limits.
+ *   Calculates the step to apply per detent from the pace of the turn,
+ *  following the _ACCEL curve. The pace is timed by the switch panel when
+ *  the detents happen, as select events may merge many of them. Reversing
+ *  restarts at 1 unit, so overshoots can be corrected detent by detent.
+ *  Parameters:
+ *  * DetentMs: ms between the last two detents of the event, UINT8_MAX when
+ *    slower or reversing.
+ *  Returns: number of units to move the value.
  */
-void WgInt::_increment()
+uint16_t WgInt::_step(uint8_t DetentMs) const
 {
-  if (*_pValue != _MaxValue)
-    (*_pValue)++;
-  else
+  uint16_t Range = _MaxValue - _MinValue;
+
+  // Take the first curve entry fast enough. Entries with steps too coarse for
+  // the range of values are skipped: the next ones are slower and finer
+  for (uint8_t Idx = 0U; Idx < _ACCEL_SIZE; Idx++)
+  {
+    uint8_t AccelStep = pgm_read_byte(&_ACCEL[Idx].Step);
+
+    if (DetentMs <= pgm_read_byte(&_ACCEL[Idx].MaxMs) &&
+        (uint16_t) AccelStep * _ACCEL_MIN_STEPS_IN_RANGE <= Range)
+      return AccelStep;
+  }
+
+  return 1U;
+}
+
+
+/*
+ *   Increments current value within limits. Accelerated steps stop at the
+ *  maximum value, so a fast turn can be used to reach it.
+ *  Parameters:
+ *  * Step: units to increment.
+ */
+void WgInt::_increment(uint16_t Step)
+{
+  if (*_pValue == _MaxValue)
     // After maximum value, cycle back to minimum
     *_pValue = _MinValue;
+  else if (_MaxValue - *_pValue > Step)
+    *_pValue += Step;
+  else
+    *_pValue = _MaxValue;
 }
 
 
 /*
- *   Decrements current value within limits.
+ *   Decrements current value within limits. Accelerated steps stop at the
+ *  minimum value, so a fast turn can be used to reach it.
+ *  Parameters:
+ *  * Step: units to decrement.
  */
-void WgInt::_decrement()
+void WgInt::_decrement(uint16_t Step)
 {
-  if (*_pValue != _MinValue)
-    (*_pValue)--;
-  else
+  if (*_pValue == _MinValue)
     // After minimum value, cycle back to maximum
     *_pValue = _MaxValue;
+  else if (*_pValue - _MinValue > Step)
+    *_pValue -= Step;
+  else
+    *_pValue = _MinValue;
 }
@@ -6,10 +6,10 @@
 #include "widget.h"
 
 
-// ISR needs to be function of type void (*)() -> cannot be defined inside class
-// because it would be defined as type void (*<class>::)(), so make it a global
-// friend function
-void _isrWgIntBlink();
+// Timer callback needs to be function of type void (*)(void *) -> cannot be
+// defined inside class because it would be defined as type
+// void (*<class>::)(void *), so make it a global friend function
+void _isrWgIntBlink(void *pObj);
 
 
 /*
@@ -18,24 +18,41 @@ void _isrWgIntBlink();
 class WgInt: public Widget
 {
 public:
-  WgInt(LiquidCrystal &Lcd, uint8_t PosX, uint8_t PosY, uint8_t Size);
+  WgInt(uint8_t PosX, uint8_t PosY, uint8_t Size);
   void init(uint16_t MinValue, uint16_t MaxValue, uint16_t *pValue);
 
-  virtual void focus();
-  virtual void unfocus();
-  virtual int8_t event(const Event &E);
+  void focus();
+  void unfocus();
+  void refresh();
+  int8_t event(const Event &E);
 
 protected:
-  friend void _isrWgIntBlink();
+  friend void _isrWgIntBlink(void *pObj);
+
+  // Acceleration curve entry: detents up to MaxMs apart move Step units.
+  // MaxMs must be below UINT8_MAX, which stands for slower detents
+  struct Accel_t
+  {
+    uint8_t MaxMs;
+    uint8_t Step;
+  };
+
+  // Acceleration curve, from fastest to slowest
+  static const Accel_t _ACCEL[] PROGMEM;
+  static const uint8_t _ACCEL_SIZE;
+
+  // Accelerated steps must fit this many times in the range of values
+  static const uint8_t _ACCEL_MIN_STEPS_IN_RANGE = 4U;
 
   // Protected methods
   void _draw() const;
   void _clear() const;
   void _drawBlinking() const;
   void _blinkOn();
-  void _blinkOff() const;
-  void _increment();
-  void _decrement();
+  void _blinkOff();
+  uint16_t _step(uint8_t DetentMs) const;
+  void _increment(uint16_t Step);
+  void _decrement(uint16_t Step);
 
   // Member data
   const uint8_t _X;     // Column where to display the widget
@@ -45,7 +62,8 @@ protected:
   uint16_t *_pValue;   // Pointer to current value where it is kept updated
   uint16_t _MinValue;  // Maximum allowed value of _Value
   uint16_t _MaxValue;  // Minimum allowed value of _Value
-  volatile bool _BlinkClear;  // When blinking: true iif displaying blank phase
+  volatile bool _BlinkClear;  // When blinking: true iif blank phase (by ISR)
+  bool _Cleared;              // Whether the LCD is showing the blank phase
 };
 
 
@@ -6,8 +6,9 @@
 /* Static constants */
 /********************/
 
-const uint8_t WgSelect::_Coord2Opt[2][2] = { {0, 0}, {0, 1} };
-const uint8_t WgSelect::_Coord4Opt[4][2] = { {0, 0}, {8, 0}, {0, 1}, {8, 1} };
+const uint8_t WgSelect::_Coord2Opt[2][2] PROGMEM = { {0, 0}, {0, 1} };
+const uint8_t WgSelect::_Coord4Opt[4][2] PROGMEM =
+  { {0, 0}, {8, 0}, {0, 1}, {8, 1} };
 
 
 /***********/
@@ -17,11 +18,9 @@ const uint8_t WgSelect::_Coord4Opt[4][2] = { {0, 0}, {8, 0}, {0, 1}, {8, 1} };
 /*
  *   Constructor. Initializes the object as a 2 or 4 select widget.
  *  Parameters:
- *  * Lcd: reference to the lcd display that is being used.
  *  * FourOptions: true iff widget has 4 available options, 2 otherwise
  */
-WgSelect::WgSelect(LiquidCrystal &Lcd, bool FourOptions):
-  Widget(Lcd),
+WgSelect::WgSelect(bool FourOptions):
   _NumOptions(FourOptions? 4U: 2U),
   _CoordOpt(FourOptions? _Coord4Opt: _Coord2Opt)
 {
@@ -60,17 +59,10 @@ int8_t WgSelect::event(const Event &E)
   if (E.Id == Event::EvSwitch)
     switch (E.Switch)
     {
-    case Event::SwEvSelectCw:
-      // Select previous option
+    case Event::SwEvSelect:
+      // Move to the option Steps away, clockwise is next
       _clearCursor();
-      _nextOption();
-      _drawCursor();
-      // Ac = AcNone;
-      break;
-    case Event::SwEvSelectCcw:
-      // Select next option
-      _clearCursor();
-      _prevOption();
+      _moveOption(E.Steps);
       _drawCursor();
       // Ac = AcNone;
       break;
@@ -98,8 +90,8 @@ void WgSelect::_drawCursor() const
   const uint8_t *pCoord = _CoordOpt[_CurOption];
 
   // Go to position and display the cursor
-  _Lcd.setCursor(pCoord[0], pCoord[1]);
-  _Lcd.write(_Cursor);
+  _pLcd->setCursor(pgm_read_byte(pCoord), pgm_read_byte(pCoord + 1));
+  _pLcd->write(_Cursor);
 }
 
 
@@ -111,29 +103,23 @@ void WgSelect::_clearCursor() const
   const uint8_t *pCoord = _CoordOpt[_CurOption];
 
   // Go to position and display the cursor
-  _Lcd.setCursor(pCoord[0], pCoord[1]);
-  _Lcd.write(' ');
+  _pLcd->setCursor(pgm_read_byte(pCoord), pgm_read_byte(pCoord + 1));
+  _pLcd->write(' ');
 }
 
 
 /*
- *   Updates _CurOption with previous option in sequence.
+ *   Updates _CurOption moving Steps options in sequence, cycling at the ends.
+ *  Parameters:
+ *  * Steps: options to move, positive forward and negative backward.
  */
-void WgSelect::_prevOption()
+void WgSelect::_moveOption(int8_t Steps)
 {
-  // Watch out for underflow when option 0 selected
-  if (!_CurOption)
-    _CurOption += _NumOptions;
-
-  // Calculate new option, no need for modulo anymore
-  _CurOption--;
-}
+  // Make the offset positive to avoid the sign in the modulo
+  int8_t Offset = Steps % (int8_t) _NumOptions;
 
+  if (Offset < 0)
+    Offset += _NumOptions;
 
-/*
- *   Updates _CurOption with next option in sequence.
- */
-void WgSelect::_nextOption()
-{
-  _CurOption = (_CurOption + uint8_t(1U)) % _NumOptions;
+  _CurOption = (_CurOption + (uint8_t) Offset) % _NumOptions;
 }
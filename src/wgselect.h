@@ -12,22 +12,21 @@
 class WgSelect: public Widget
 {
 public:
-  WgSelect(LiquidCrystal &Lcd, bool FourOptions);
-  virtual void focus();
-  virtual int8_t event(const Event &E);
+  WgSelect(bool FourOptions);
+  void focus();
+  int8_t event(const Event &E);
 
 protected:
   // Cursor character
   static const char _Cursor = '*';
   // Coordinates where to draw the cursor in the LCD
-  static const uint8_t _Coord2Opt[2][2];
-  static const uint8_t _Coord4Opt[4][2];
+  static const uint8_t _Coord2Opt[2][2] PROGMEM;
+  static const uint8_t _Coord4Opt[4][2] PROGMEM;
 
   // Protected methods
   void _drawCursor() const;
   void _clearCursor() const;
-  void _prevOption();
-  void _nextOption();
+  void _moveOption(int8_t Steps);
 
   // Member data
   const uint8_t _NumOptions;  // Whether a 2 or 4 option select
@@ -7,6 +7,11 @@
 #include "event.h"
 
 
+/*
+ *   Base class for the widgets. Widgets are not polymorphic: the pages own
+ *  them by their concrete classes and call focus(), event() and refresh()
+ *  directly, so no virtual tables are needed.
+ */
 class Widget
 {
 public:
@@ -15,18 +20,11 @@ public:
   static const int8_t AcNone = -2;
   static const int8_t AcBack = -3;
 
-  Widget(LiquidCrystal &Lcd):
-    _Lcd(Lcd)
-  {
-  }
-
-  // Abstract virtual methods
-  virtual void focus() = 0;
-  virtual int8_t event(const Event &E) = 0;
-
 protected:
-  // Member data
-  LiquidCrystal &_Lcd;
+  friend class Display;
+
+  // LCD shared by all the widgets, set by the Display
+  static LiquidCrystal *_pLcd;
 };
 
-#endif  // _WIDGET_H_
\ No newline at end of file
+#endif  // _WIDGET_H_